@@ -7,7 +7,8 @@
 #include <span>
 #include <array>
 #include <cmath>		// std::fma, std::lerp
-#include <algorithm>	// std::sort, std::clamp
+#include <algorithm>	// std::sort, std::clamp, std::nth_element
+#include <utility>		// std::pair
 
 
 namespace pax { 
@@ -26,6 +27,28 @@ namespace pax {
 		return sp_;
 	}
 
+	namespace detail {
+		template< typename Itr >
+		constexpr void select_ranks( const Itr begin_, Itr first_, const Itr last_, std::span< const std::size_t > ranks_ ) noexcept {
+			while( !ranks_.empty() ) {
+				const std::size_t	mid = ranks_.size()/2;
+				const Itr			nth = begin_ + ranks_[ mid ];
+				std::nth_element( first_, nth, last_ );
+				select_ranks( begin_, first_, nth, ranks_.first( mid ) );
+				first_			  = nth + 1;
+				ranks_			  = ranks_.subspan( mid + 1 );
+			}
+		}
+	}
+
+	/// Partially order the items, so that the item at each of the ranks_ is the one that would be there if sorted.
+	/** ranks_ must be sorted, unique, and less than sp_.size(). 
+		This is linear for a few ranks (O(n log k) for k ranks), instead of the O(n log n) of sorting.	**/
+	template< typename T, std::size_t N >
+	constexpr void select_ranks( const std::span< T, N > sp_, const std::span< const std::size_t > ranks_ ) noexcept {
+		detail::select_ranks( sp_.begin(), sp_.begin(), sp_.end(), ranks_ );
+	}
+
 
 
 namespace ordered {
@@ -66,15 +89,23 @@ namespace ordered {
 
 
 
+	/// Where quantile q_ of size_ (> 0) samples is: the index of the sample below it and the fraction to the next sample.
+	/** q_ is clamped to [0, 1]. quantile uses the samples at the index and, if there is one, at the index + 1. 	**/
+	template< std::floating_point F >
+	constexpr std::pair< std::size_t, F > quantile_position( const std::size_t size_, const double q_ ) noexcept	{
+		const F					f{ std::clamp( F( q_ ), F( 0 ), F( 1 ) ) * ( size_ - 1 ) };
+		const std::size_t		i( f );
+		return { i, f - i };
+	}
+
 	/// Return the quantile, calculated by linear interpolating of the nearest samples. 
 	/** q_ is clamped to [0, 1]. 
 		If sp_ is not ordered, the result is undefined. If sp_ is empty, NaN is returned.	**/
 	template< std::floating_point F, std::size_t N >
 	constexpr F quantile( const std::span< F, N > sp_, const double q_ ) 	noexcept	{
 		if( sp_.size() ) {
-			const F				f{ std::clamp( F( q_ ), F( 0 ), F( 1 ) ) * ( sp_.size() - 1 ) };
-			const std::size_t	i( f );
-			return	( sp_.size() > i + 1 )	? std::lerp( sp_[ i ], sp_[ i+1 ], f - i )
+			const auto [ i, fraction ]	= quantile_position< std::remove_cv_t< F > >( sp_.size(), q_ );
+			return	( sp_.size() > i + 1 )	? std::lerp( sp_[ i ], sp_[ i+1 ], fraction )
 											: sp_.back();
 		}
 		return NaN< F >;
@@ -167,6 +198,7 @@ namespace ordered {
 	template< std::size_t r, std::floating_point F > 	class L_moment_array;
 	template< std::size_t r >							struct TL_moment_detail;
 	template< std::size_t r, std::floating_point F > 	class TL_moment_array;
+	template< std::floating_point F > 					class L_moment_kernel;
 
 
 	/// Return the L-moment of order r. 
@@ -387,6 +419,7 @@ namespace ordered {
 		using V						  = std::remove_cv_t< F >;
 		using Base					  = std::array< std::remove_cv_t< F >, r+1 >;
 		struct TL_moment_recursive;
+		template< std::floating_point >		friend class L_moment_kernel;
 
 	public:
 		// This is public, so that it may be tested...
@@ -489,4 +522,74 @@ namespace ordered {
 		) const noexcept	{	return TL_moment_array< r, F >( sp_, s_, t_ )[ r ];		}
 	};
 
+
+
+	/// L-moments 1 to 4, their ratios, and (optionally) the TL-moments 1 to 4, all from a single traversal.
+	/** The L-moments are calculated from the probability weighted moments b_0 to b_3, so each value is only 
+		multiplied by three running products (and the sums are in double). The TL-moments, with the symmetric 
+		trimming trim_, are calculated in the same traversal, as by TL_moment_array.
+		A moment of a higher order than there are (untrimmed) values is NaN. If sp_ is not ordered, the result is undefined.	**/
+	template< std::floating_point F > 
+	class L_moment_kernel {
+		using V						  = std::remove_cv_t< F >;
+		std::array< V, 5 >				m_l, m_tl;			// Index r is the (TL-)moment of order r.
+		std::size_t						m_trim{};
+
+	public:
+		/// All moments are NaN.
+		constexpr L_moment_kernel() noexcept	{
+			m_l.fill( NaN< V > );
+			m_tl.fill( NaN< V > );
+		}
+
+		template< std::floating_point Fsp, std::size_t N >
+		constexpr explicit L_moment_kernel( const std::span< Fsp, N > sp_, const std::size_t trim_ = 0 ) noexcept
+			: L_moment_kernel{} 
+		{
+			const std::size_t			n = sp_.size();
+			const bool					trimmed = ( trim_ > 0 ) && ( n > 2*trim_ );
+			using W_type				  = typename TL_moment_array< 4, double >::TL_moment_recursive;
+			W_type						W( trimmed ? n : 2*trim_ + 1, trim_, trim_ );
+			std::array< double, 4 >		b{};			// n*( n-1 )*...*( n-k )*b_k.
+			std::array< double, 5 >		tl{};
+			m_trim						  = trim_;
+			for( std::size_t j{}; j<n; ++j ) {
+				const double			x = sp_[ j ];
+				const double			p1 = j, p2 = p1*( p1 - 1 ), p3 = p2*( p1 - 2 );
+				b[ 0 ]					 += x;
+				b[ 1 ]					 += x*p1;
+				b[ 2 ]					 += x*p2;
+				b[ 3 ]					 += x*p3;
+				if( trimmed && ( j >= trim_ ) && ( j < n - trim_ ) ) {
+					for( std::size_t R=1; R<=4; ++R )	tl[ R ] += x*W[ R ];
+					++W;
+				}
+			}
+
+			double						denominator{ 1 };
+			for( std::size_t k{}; ( k < 4 ) && ( k < n ); ++k )
+				b[ k ]					 /= ( denominator *= double( n - k ) );
+			if( n >= 1 )				m_l[ 1 ] = V( b[ 0 ] );
+			if( n >= 2 )				m_l[ 2 ] = V(  2*b[ 1 ] -   b[ 0 ] );
+			if( n >= 3 )				m_l[ 3 ] = V(  6*b[ 2 ] -  6*b[ 1 ] +    b[ 0 ] );
+			if( n >= 4 )				m_l[ 4 ] = V( 20*b[ 3 ] - 30*b[ 2 ] + 12*b[ 1 ] - b[ 0 ] );
+			if( trimmed )
+				for( std::size_t R=1; ( R<=4 ) && ( R < n - 2*trim_ ); ++R )	m_tl[ R ] = V( tl[ R ] );
+		}
+
+		/// The L-moment of order r_ (1 to 4).
+		constexpr V L( const std::size_t r_ )				const noexcept	{	return m_l[ r_ ];				}
+
+		/// The L-moment ratio of order r_: L-CV, L( 2 )/L( 1 ), for r_ = 2 and L( r_ )/L( 2 ) for r_ = 3 and 4.
+		constexpr V L_ratio( const std::size_t r_ )			const noexcept	{
+			return m_l[ r_ ]/m_l[ ( r_ == 2 ) ? 1 : 2 ];
+		}
+
+		/// The TL-moment of order r_ (1 to 4), with the trimming trim(). NaN if there is no trimming.
+		constexpr V TL( const std::size_t r_ )				const noexcept	{	return m_tl[ r_ ];				}
+
+		/// The symmetric trimming of the TL-moments.
+		constexpr std::size_t trim()						const noexcept	{	return m_trim;					}
+	};
+
 }}	// namespace pax::ordered
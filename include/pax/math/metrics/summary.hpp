@@ -6,7 +6,10 @@
 
 #include <span>
 #include <cmath>		// std::root, std::isnan, etc.
+#include <algorithm>	// std::copy
 #include <array>
+#include <iterator>		// std::contiguous_iterator
+#include <memory>		// std::to_address
 #include <type_traits>
 
 
@@ -86,6 +89,9 @@ namespace pax {
 		using summary_type								  = T;
 		static constexpr std::size_t						level{ P };
 		static constexpr bool								uses_weights{ Meta< T >::uses_weights };
+
+		/// The type the sums are accumulated in by the bulk push_back: at least double for float values.
+		using accumulator_type							  = std::conditional_t< std::is_same_v< value_type, float >, double, value_type >;
 	
 		constexpr Summary()									noexcept = default;
 		constexpr Summary( const Summary & )				noexcept = default;
@@ -99,6 +105,82 @@ namespace pax {
 			eat< P >( v_ );
 		}			
 
+		/// Add a bunch of values (with weights) to the sums. 
+		/** The same as pushing them one by one, but much faster for many values:
+			- The power sums are accumulated in independent lanes (that the compiler vectorises, e.g. to AVX2 or 
+			  AVX-512, depending on the target) instead of in a single dependency chain, and are then added up.
+			- float values are accumulated as accumulator_type (double). 
+			As the values are added in a different order and precision, the sums may differ from those of pushing 
+			them one by one by rounding errors: a relative 1e-6 for float values and 1e-14 for double, typically.	**/
+		template< typename U, std::size_t N >	requires std::same_as< std::remove_const_t< U >, summary_type >
+		constexpr void push_back( const std::span< U, N > values_ )	noexcept	{
+			using A						  = accumulator_type;
+			constexpr std::size_t			lanes{ 8 };
+			std::array< std::array< A, lanes >, P >		sums{}, weights{};
+
+			const auto	block = [ & ]( const summary_type * v_ ) {
+				std::array< A, lanes >		x{}, w{}, px{}, pw{};
+				for( std::size_t l{}; l<lanes; ++l ) {
+					if constexpr( uses_weights ) {
+						x[ l ]			  = A( v_[ l ].x );
+						w[ l ]			  = A( v_[ l ].w );
+						px[ l ]			  = x[ l ]*w[ l ];
+						pw[ l ]			  = w[ l ];
+					} else {
+						x[ l ]			  = A( v_[ l ] );
+						px[ l ]			  = x[ l ];
+					}
+				}
+				for( std::size_t p{}; p<P; ++p )
+					for( std::size_t l{}; l<lanes; ++l ) {
+						sums[ p ][ l ]	 += px[ l ];
+						px[ l ]			 *= x[ l ];
+						if constexpr( uses_weights ) {
+							weights[ p ][ l ]	 += pw[ l ];
+							pw[ l ]			 *= w[ l ];
+						}
+					}
+			};
+
+			std::size_t						i{};
+			for( ; i + lanes <= values_.size(); i += lanes )	block( values_.data() + i );
+			if( i < values_.size() ) {		// The rest, padded with zeros (that add nothing).
+				std::array< summary_type, lanes >	rest{};
+				std::copy( values_.begin() + i, values_.end(), rest.begin() );
+				block( rest.data() );
+			}
+
+			for( std::size_t p{}; p<P; ++p ) {
+				A							sum{}, weight{};
+				for( std::size_t l{}; l<lanes; ++l ) {
+					sum					 += sums[ p ][ l ];
+					weight				 += weights[ p ][ l ];
+				}
+				if constexpr( uses_weights ) {
+					m_sum[ p ].x		  = value_type( A( m_sum[ p ].x ) + sum );
+					m_sum[ p ].w		  = value_type( A( m_sum[ p ].w ) + weight );
+				} else {
+					m_sum[ p ]			  = summary_type( A( m_sum[ p ] ) + sum );
+				}
+			}
+			m_count						 += values_.size();
+		}
+
+		/// Add the values of other_, as if they were pushed here. 
+		/** The power sums are just added, so e.g. summaries of parts of the values (per thread or per tile) 
+			can be merged into the summary of all of them.														**/
+		constexpr Summary & merge( const Summary & other_ )		noexcept	{
+			m_count						 += other_.m_count;
+			for( std::size_t p{}; p<P; ++p )	m_sum[ p ] += other_.m_sum[ p ];
+			return *this;
+		}
+
+		/// Same as merge( other_ ).
+		constexpr Summary & operator+=( const Summary & other_ )	noexcept	{	return merge( other_ );	}
+
+		/// The summary of the values of both a_ and b_.
+		friend constexpr Summary operator+( Summary a_, const Summary & b_ )	noexcept	{	return a_.merge( b_ );	}
+
 		/// Get an std::span to the sums: { sum(x), sum(x^2), ... }.
 		constexpr auto span()								const noexcept	{
 			return std::span< const summary_type, P >( m_sum.data(), P );
@@ -144,12 +226,14 @@ namespace pax {
 
 
 
-	/// Create a Summary from two iterators.
+	/// Create a Summary from two iterators. Contiguous values are pushed in bulk.
 	template< std::size_t P = 4, typename Iterator >
 	constexpr auto summary( Iterator iter_, const Iterator end_ ) noexcept {
 		using T = std::decay_t< decltype( *iter_ ) >;
 		Summary< T, P >	sum;
-		while( iter_ != end_ ) {
+		if constexpr( std::contiguous_iterator< Iterator > ) {
+			sum.push_back( std::span< const T >( std::to_address( iter_ ), std::size_t( end_ - iter_ ) ) );
+		} else while( iter_ != end_ ) {
 			sum.push_back( *iter_ );
 			++iter_;
 		}
@@ -6,6 +6,7 @@
 
 #include "filter.hpp"
 #include "function.hpp"
+#include "metric-sets.hpp"
 #include "point-aggregator.hpp"
 
 #include <vector>
@@ -29,7 +30,7 @@ namespace pax::metrics {
 	
 		template< typename Out >
 		static Out & print_sets( Out & out_, const std::string_view pre_ ) {
-			for( const auto name : { "basic-linear", "inka-berries", "extra-allt" } ) {
+			for( const auto name : { Basic_linear::name, Inka_berries::name, Extra_allt::name } ) {
 				const auto items = create_set( name, 9.99 );
 				out_ << pre_ << "    " << name << ": [";
 				for( const auto item : items )		out_ << item << " ";
@@ -68,8 +69,8 @@ namespace pax::metrics {
 			return m_function( acc_.ordered_span( m_filter ) );
 		}
 
-		Function function()							const noexcept	{	return m_function;		}
-		Filter filter()								const noexcept	{	return m_filter;		}
+		constexpr Function function()				const noexcept	{	return m_function;		}
+		constexpr Filter filter()					const noexcept	{	return m_filter;		}
 		
 		bool operator==( const Function_filter o_ )	const noexcept	{
 			return	( m_function == o_.m_function )
@@ -112,46 +113,26 @@ namespace pax::metrics {
 		}
 
 
+		/// The metrics of the preconfigured set Set (e.g. Basic_linear), in the order of Set::metrics.
+		template< typename Set >
+		static std::vector< Function_filter > create_set( const metrics_value_type nilsson_ ) {
+			const auto						filters = Set::filters( nilsson_ );
+			std::vector< Function_filter >	collection{};
+			collection.reserve( Set::metrics.size() );
+			for( const auto & metric : Set::metrics )
+				collection.emplace_back( metric.function, filters[ metric.filter ] );
+			return collection;
+		}
+
 		static std::vector< Function_filter > create_set( const std::string_view id_, const metrics_value_type nilsson_ ) {
-			if       ( id_ == "basic-linear" ) {
-				return { 
-					{ Function::count(),	Filter:: all()				},
-					{ Function::variance(),	Filter:: all_ge( nilsson_ )	},
-					{ Function::p( 30 ),	Filter:: all_ge( nilsson_ )	},
-					{ Function::p( 80 ),	Filter:: all_ge( nilsson_ )	},
-					{ Function::p( 95 ),	Filter:: all_ge( nilsson_ )	},
-					{ Function::count(),	Filter::ret1_ge( nilsson_ )	},
-					{ Function::count(),	Filter::ret1()				}
-				};
-
-			} else if( id_ == "inka-berries" ) {
-				return { 
-					{ Function::L3(),		Filter:: all()				},
-					{ Function::p( 30 ),	Filter:: all()				}, 
-					{ Function::count(),	Filter::ret1_ge( nilsson_ )	}, 
-					{ Function::count(),	Filter::ret1()				}, 
-					{ Function::mean2(),	Filter::ret1()				}
-				};
-
-			} else if( id_ == "extra-allt" ) {
-				std::vector< Function_filter >	collection{};
-
-				for( const Filter filter : {
-					Filter:: all_ge( 5 ), Filter:: all_ge( 10 ), Filter:: all_ge( 15 ),
-					Filter::ret1_ge( 5 ), Filter::ret1_ge( 10 ), Filter::ret1_ge( 15 )
-				} )	collection.emplace_back( Function::count(), filter );
-
-				for( const Function function : {
-					Function::count(),	Function::mean(),	Function::mean2(),	Function::variance(), 
-					Function::skewness(),					Function::kurtosis(), 
-					Function::p( 10 ),	Function::p( 20 ),	Function::p( 30 ),	Function::p( 40 ),	Function::p( 50 ), 
-					Function::p( 60 ),	Function::p( 70 ),	Function::p( 80 ),	Function::p( 90 ),	Function::p( 95 ), 
-					Function::L2(),   	Function::L3(),   	Function::L4(),   	Function::mad()
-				} ) for( const auto filter : { 
-					Filter::all(),		Filter::all_ge( nilsson_ ), 
-					Filter::ret1(),		Filter::ret1_ge( nilsson_ )
-				} )	collection.emplace_back( function, filter );
-				
+			if       ( id_ == Basic_linear::name ) {
+				return create_set< Basic_linear >( nilsson_ );
+
+			} else if( id_ == Inka_berries::name ) {
+				return create_set< Inka_berries >( nilsson_ );
+
+			} else if( id_ == Extra_allt::name ) {
+				auto						collection = create_set< Extra_allt >( nilsson_ );
 				std::sort( collection.begin(), collection.end() );
 				return collection;
 			}
@@ -9,6 +9,7 @@
 #include <pax/reporting/error_message.hpp>
 #include <pax/textual/from_string.hpp>
 
+#include <optional>
 #include <string_view>
 
 
@@ -18,7 +19,8 @@ namespace pax::metrics {
 		
 		enum function : std::uint8_t {
 			f_count, f_mean, f_mean2, f_variance, f_skewness, f_kurtosis, 
-			f_L2, f_L3, f_L4, f_mad, f_pN, f_unidentified,
+			f_L2, f_L3, f_L4, f_Lcv, f_Lskew, f_Lkurt, f_TL1, f_TL2, f_TL3, f_TL4, 
+			f_mad, f_pN, f_unidentified,
 			f_with_args = f_pN, 
 			f_last		= f_pN, 
 		};
@@ -45,6 +47,13 @@ namespace pax::metrics {
 			{	"L2",		"L2-moment (L-scale)."						}, 
 			{	"L3",		"L3-moment (L-skewness)."					}, 
 			{	"L4",		"L4-moment (L-kurtosis)."					}, 
+			{	"Lcv",		"L-moment ratio L2/L1 (L-CV)."				}, 
+			{	"Lskew",	"L-moment ratio L3/L2 (L-skewness ratio)."	}, 
+			{	"Lkurt",	"L-moment ratio L4/L2 (L-kurtosis ratio)."	}, 
+			{	"TL1",		"TL1-moment, trimmed by one at each end."	}, 
+			{	"TL2",		"TL2-moment, trimmed by one at each end."	}, 
+			{	"TL3",		"TL3-moment, trimmed by one at each end."	}, 
+			{	"TL4",		"TL4-moment, trimmed by one at each end."	}, 
 			{	"mad",		"Median absolute deviation."				}, 
 			{	"p{}",		"Percentile {}, where {} is in [0, 100]."	}
 		};
@@ -94,11 +103,21 @@ namespace pax::metrics {
 		static constexpr Function L2()								  noexcept	{	return Function( f_L2 );		}
 		static constexpr Function L3()								  noexcept	{	return Function( f_L3 );		}
 		static constexpr Function L4()								  noexcept	{	return Function( f_L4 );		}
+		static constexpr Function Lcv()								  noexcept	{	return Function( f_Lcv );		}
+		static constexpr Function Lskew()							  noexcept	{	return Function( f_Lskew );		}
+		static constexpr Function Lkurt()							  noexcept	{	return Function( f_Lkurt );		}
+		static constexpr Function TL1()								  noexcept	{	return Function( f_TL1 );		}
+		static constexpr Function TL2()								  noexcept	{	return Function( f_TL2 );		}
+		static constexpr Function TL3()								  noexcept	{	return Function( f_TL3 );		}
+		static constexpr Function TL4()								  noexcept	{	return Function( f_TL4 );		}
 		static constexpr Function mad()								  noexcept	{	return Function( f_mad );		}
 		static constexpr Function p( unsigned p_ )					  noexcept	{
 			return Function( f_pN, ( p_ <= 100 ) ? p_ : 100 );
 		}
 
+		/// The symmetric trimming of the TL-moments (TL1 to TL4).
+		static constexpr std::size_t		TL_trim{ 1 };
+
 		/// Return the description string of the Function. 
 		constexpr auto description()							const noexcept	{
 			return id_descr[ int( m_function ) ].descr;
@@ -109,6 +128,8 @@ namespace pax::metrics {
 		template< typename T >
 		constexpr T operator()( const std::span< T > ordered_ )	const			{
 			using namespace ordered;
+			if( uses_L_moments() )		return ( *this )( ordered_, Summary< std::remove_cv_t< T >, 0 >{}, 
+											L_moment_kernel< std::remove_cv_t< T > >( ordered_, uses_TL_moments() ? TL_trim : 0 ) );
 			switch( m_function ) {
 				case f_count: 			return					 	 ordered_.size();
 				case f_mean: 			return pax::mean			( summary< 1 >( ordered_ ) );
@@ -116,16 +137,80 @@ namespace pax::metrics {
 				case f_variance: 		return pax::sample_variance	( summary< 2 >( ordered_ ) );
 				case f_skewness: 		return pax::sample_skewness	( summary< 3 >( ordered_ ) );
 				case f_kurtosis: 		return pax::sample_kurtosis	( summary< 4 >( ordered_ ) );
-				case f_L2:				return L_moment< 2 >		( ordered_ );
-				case f_L3:				return L_moment< 3 >		( ordered_ );
-				case f_L4:				return L_moment< 4 >		( ordered_ );
 				case f_mad: 			return median_mad			( ordered_ ).mad();
-				case f_pN: 				return percentile			( ordered_, m_percentile );
-				case f_unidentified:	return std::numeric_limits< T >::quiet_NaN();
+				case f_pN: 				return ordered::percentile	( ordered_, m_percentile );
+				default:				return std::numeric_limits< T >::quiet_NaN();
 			}
 			// A final return statement is required by gcc.
 			return std::numeric_limits< T >::quiet_NaN();
 		}
+
+		/// The Summary level the function needs (zero if it does not use a Summary).
+		constexpr std::size_t summary_level()					const noexcept	{
+			switch( m_function ) {
+				case f_mean: 			return 1;
+				case f_mean2: 			return 2;
+				case f_variance: 		return 2;
+				case f_skewness: 		return 3;
+				case f_kurtosis: 		return 4;
+				default: 				return 0;
+			}
+		}
+
+		/// Does the function use the L-moments or TL-moments of an ordered::L_moment_kernel?
+		constexpr bool uses_L_moments()							const noexcept	{
+			return ( m_function >= f_L2 ) && ( m_function <= f_TL4 );
+		}
+
+		/// Does the function use the TL-moments of an ordered::L_moment_kernel (with trimming TL_trim)?
+		constexpr bool uses_TL_moments()						const noexcept	{
+			return ( m_function >= f_TL1 ) && ( m_function <= f_TL4 );
+		}
+
+		/// Does the function need all values ordered? Otherwise it is a count or a percentile, that only need a few order statistics.
+		constexpr bool needs_order()							const noexcept	{
+			return ( m_function != f_count ) && ( m_function != f_pN );
+		}
+
+		/// The percentile, if the function is a percentile.
+		constexpr std::optional< std::size_t > percentile()		const noexcept	{
+			return ( m_function == f_pN ) ? std::optional< std::size_t >( m_percentile ) : std::nullopt;
+		}
+
+		/// Calculate the metric for data_, using a Summary and L-moments already calculated from it. 
+		/** This is for sharing work between functions on the same data (see Metric_plan).
+			- summary_ must be of ordered_ and of at least level summary_level().
+			- l_ must be of ordered_ if uses_L_moments(), with the trimming TL_trim if uses_TL_moments().
+			  With another trimming, the TL-moments are calculated from ordered_.
+			- Other functions are calculated from ordered_, as usual.										**/
+		template< typename T, typename S, std::size_t P >
+		constexpr T operator()( 
+			const std::span< T >						ordered_,
+			const Summary< S, P >					  & summary_,
+			const ordered::L_moment_kernel< std::remove_cv_t< T > >	& l_
+		)														const			{
+			if( uses_TL_moments() && ( l_.trim() != TL_trim ) )
+				return ( *this )( ordered_ );
+			switch( m_function ) {
+				case f_mean: 		if constexpr( P >= 1 )	return pax::mean			( summary_ );	break;
+				case f_mean2: 		if constexpr( P >= 2 )	return pax::mean< 2 >		( summary_ );	break;
+				case f_variance: 	if constexpr( P >= 2 )	return pax::sample_variance	( summary_ );	break;
+				case f_skewness: 	if constexpr( P >= 3 )	return pax::sample_skewness	( summary_ );	break;
+				case f_kurtosis: 	if constexpr( P >= 4 )	return pax::sample_kurtosis	( summary_ );	break;
+				case f_L2:									return l_.L( 2 );
+				case f_L3:									return l_.L( 3 );
+				case f_L4:									return l_.L( 4 );
+				case f_Lcv:									return l_.L_ratio( 2 );
+				case f_Lskew:								return l_.L_ratio( 3 );
+				case f_Lkurt:								return l_.L_ratio( 4 );
+				case f_TL1:									return l_.TL( 1 );
+				case f_TL2:									return l_.TL( 2 );
+				case f_TL3:									return l_.TL( 3 );
+				case f_TL4:									return l_.TL( 4 );
+				default:									break;
+			}
+			return ( *this )( ordered_ );
+		}
 		
 		constexpr bool operator==( const Function f_ )			const noexcept	{
 			return	( m_function   == f_.m_function   )
@@ -0,0 +1,105 @@
+//	Copyright (c) 2014-2022, Peder Axensten, all rights reserved.
+//	Contact: peder ( at ) axensten.se
+
+
+#pragma once
+
+#include "function-filter.hpp"
+
+#include <algorithm>	// std::all_of, std::lower_bound, std::sort, std::unique
+#include <cstdint>		// std::uint32_t
+#include <span>
+#include <utility>		// std::pair
+#include <vector>
+
+
+namespace pax::metrics {
+
+	/// Cumulative height histograms of many cells (e.g. the pixels of a raster), for metric sets of only counts.
+	/** The filter levels are in whole cm, so a metric set has only a few distinct levels. For each cell and each
+		level, the number of heights below the level is kept (for all points and for the first returns).
+		The count of a filter is then a single subtraction, there are no values to keep or to sort.
+		The counts are the same as Function::count() of Point_aggregator::ordered_span( filter ).					**/
+	class Height_histograms {
+		using V							  = metrics_value_type;
+		using count_type				  = std::uint32_t;
+
+		std::vector< V >					m_levels{};		// The distinct filter levels, ascending.
+		std::vector< std::pair< std::size_t, std::size_t > >	m_metrics{};	// The offsets (in a cell) of the max and min level.
+		std::vector< count_type >			m_counts{};		// Per cell: the counts below each level, for all and then for the first returns.
+
+		constexpr std::size_t stride()						const noexcept	{	return 2*m_levels.size();	}
+
+		std::size_t offset( const bool first_only_, const V level_ )	const noexcept	{
+			return ( first_only_ ? m_levels.size() : 0 )
+				+ ( std::lower_bound( m_levels.begin(), m_levels.end(), level_ ) - m_levels.begin() );
+		}
+
+	public:
+		Height_histograms()									  = default;
+
+		/// Are all metrics_ counts?
+		static bool suitable( const std::span< const Function_filter > metrics_ ) noexcept {
+			return std::all_of( metrics_.begin(), metrics_.end(),
+				[]( const Function_filter & m_ ){ return m_.function() == Function::count(); } );
+		}
+
+		/// Histograms of cells_ cells, for metrics_. Throws if metrics_ is not suitable.
+		Height_histograms( const std::span< const Function_filter > metrics_, const std::size_t cells_ ) {
+			if( !suitable( metrics_ ) )
+				throw error_message( "Height_histograms: all the metrics must be counts." );
+
+			for( const auto & metric : metrics_ ) {
+				m_levels.push_back( metric.filter().min_level() );
+				m_levels.push_back( metric.filter().max_level() );
+			}
+			std::sort( m_levels.begin(), m_levels.end() );
+			m_levels.erase( std::unique( m_levels.begin(), m_levels.end() ), m_levels.end() );
+
+			m_metrics.reserve( metrics_.size() );
+			for( const auto & metric : metrics_ ) {
+				const Filter				filter = metric.filter();
+				m_metrics.emplace_back( offset( filter.first_only(), filter.max_level() ), offset( filter.first_only(), filter.min_level() ) );
+			}
+			m_counts.resize( cells_*stride() );
+		}
+
+		/// The number of cells.
+		std::size_t cells()									const noexcept	{	return stride() ? m_counts.size()/stride() : 0;	}
+
+		/// The number of metrics.
+		std::size_t size()									const noexcept	{	return m_metrics.size();	}
+
+		/// The distinct filter levels, ascending.
+		std::span< const V > levels()						const noexcept	{	return m_levels;			}
+
+		/// Push a height to cell_.
+		void push_back(
+			const std::size_t		cell_,
+			const V					z_,
+			const bool				is_first_return_
+		) noexcept {
+			count_type			  * counts = m_counts.data() + cell_*stride();
+			const std::size_t		levels = m_levels.size();
+			for( std::size_t k{}; k<levels; ++k )		counts[ k ] += ( z_ < m_levels[ k ] );
+			if( is_first_return_ )
+				for( std::size_t k{}; k<levels; ++k )	counts[ levels + k ] += ( z_ < m_levels[ k ] );
+		}
+
+		/// Calculate the metrics for cell_ and put them in values_, in the order of the metric set.
+		/// values_.size() must be size().
+		void calculate( const std::size_t cell_, const std::span< V > values_ )	const noexcept {
+			const count_type		  * counts = m_counts.data() + cell_*stride();
+			for( std::size_t m{}; m<m_metrics.size(); ++m )
+				values_[ m ]		  = counts[ m_metrics[ m ].first ] - counts[ m_metrics[ m ].second ];
+		}
+
+		/// Calculate the metrics for cell_.
+		std::vector< V > operator()( const std::size_t cell_ )	const {
+			std::vector< V >				values( size() );
+			calculate( cell_, values );
+			return values;
+		}
+	};
+
+}	// namespace pax::metrics
@@ -0,0 +1,219 @@
+//	Copyright (c) 2014-2022, Peder Axensten, all rights reserved.
+//	Contact: peder ( at ) axensten.se
+
+
+#pragma once
+
+#include "metric-plan.hpp"
+#include "metric-sets.hpp"
+
+#include <algorithm>	// std::any_of, std::count_if, std::find
+#include <cmath>		// std::isfinite
+#include <optional>
+#include <utility>		// std::index_sequence
+#include <variant>
+#include <vector>
+
+
+namespace pax::metrics {
+
+	/// Calculates the preconfigured metric set Set (e.g. Basic_linear), specialised at compile time.
+	/** Does the same as Metric_plan, with the same results, but the grouping by filter, the summary levels,
+		whether the L-moments are needed, and the percentiles are all known at compile time. So there is no per metric dispatch.
+		The values are put in the order of the requested metrics, that may be a permutation of Set::metrics.	**/
+	template< typename Set >
+	class Fused_kernel {
+		using V							  = metrics_value_type;
+		static constexpr auto				set_filters = Set::filters( 0 );	// Only for what does not depend on the nilsson level.
+		static constexpr std::size_t		filter_count = set_filters.size();
+		static constexpr std::size_t		metric_count = Set::metrics.size();
+
+		// Does any metric on all values (or on the first returns) need them ordered?
+		template< bool First_only >
+		static constexpr bool				needs_order = std::any_of( Set::metrics.begin(), Set::metrics.end(),
+			[]( const Metric_descriptor & m_ ){ return ( set_filters[ m_.filter ].first_only() == First_only ) && m_.function.needs_order(); } );
+
+		template< std::size_t F >
+		static constexpr std::size_t		summary_level = []{
+			std::size_t						level{};
+			for( const auto & m : Set::metrics )	if( m.filter == F )	level = std::max( level, m.function.summary_level() );
+			return level;
+		}();
+
+		// Does any metric of filter F use the L-moments (or the TL-moments)?
+		template< std::size_t F, bool TL >
+		static constexpr bool				uses_L_moments = std::any_of( Set::metrics.begin(), Set::metrics.end(),
+			[]( const Metric_descriptor & m_ ){ return ( m_.filter == F ) && ( TL ? m_.function.uses_TL_moments() : m_.function.uses_L_moments() ); } );
+
+		template< std::size_t F >
+		static constexpr std::size_t		percentile_count = std::count_if( Set::metrics.begin(), Set::metrics.end(),
+			[]( const Metric_descriptor & m_ ){ return ( m_.filter == F ) && m_.function.percentile(); } );
+
+		template< std::size_t F >
+		static constexpr std::array< std::size_t, percentile_count< F > >	percentiles = []{
+			std::array< std::size_t, percentile_count< F > >	result{};
+			std::size_t						i{};
+			for( const auto & m : Set::metrics )	if( ( m.filter == F ) && m.function.percentile() )	result[ i++ ] = *m.function.percentile();
+			return result;
+		}();
+
+		std::array< Filter, filter_count >	m_filters;
+		std::array< std::size_t, metric_count >	m_index;		// Where to put the value of metric m.
+
+		Fused_kernel( const metrics_value_type nilsson_, const std::array< std::size_t, metric_count > & index_ ) noexcept
+			: m_filters{ Set::filters( nilsson_ ) }, m_index{ index_ } {}
+
+		// Metric M, calculated from the values of its filter.
+		template< std::size_t M, typename S >
+		static V evaluate( const std::span< const V > ordered_, const S & summary_, const ordered::L_moment_kernel< V > & l_ ) noexcept {
+			constexpr Function				f = Set::metrics[ M ].function;
+			if      constexpr( f == Function::count() )		return ordered_.size();
+			else if constexpr( f == Function::mean() )		return pax::mean			( summary_ );
+			else if constexpr( f == Function::mean2() )		return pax::mean< 2 >		( summary_ );
+			else if constexpr( f == Function::variance() )	return pax::sample_variance	( summary_ );
+			else if constexpr( f == Function::skewness() )	return pax::sample_skewness	( summary_ );
+			else if constexpr( f == Function::kurtosis() )	return pax::sample_kurtosis	( summary_ );
+			else if constexpr( f == Function::L2() )		return l_.L( 2 );
+			else if constexpr( f == Function::L3() )		return l_.L( 3 );
+			else if constexpr( f == Function::L4() )		return l_.L( 4 );
+			else if constexpr( f == Function::mad() )		return ordered::median_mad( ordered_ ).mad();
+			else if constexpr( f.percentile().has_value() )	return ordered::percentile( ordered_, *f.percentile() );
+			else											return f( ordered_, summary_, l_ );
+		}
+
+		template< std::size_t F, std::size_t M, typename S >
+		void evaluate_if(
+			const std::span< const V >		ordered_,
+			const S						  & summary_,
+			const ordered::L_moment_kernel< V >	& l_,
+			const std::span< V >			values_
+		) const noexcept {
+			if constexpr( Set::metrics[ M ].filter == F )	values_[ m_index[ M ] ] = evaluate< M >( ordered_, summary_, l_ );
+		}
+
+		// Calculate the metrics of filter F.
+		template< std::size_t F >
+		void calculate( Point_aggregator & acc_, const std::span< V > values_ ) const {
+			constexpr bool					first_only = set_filters[ F ].first_only();
+			const auto	evaluate_all = [ & ]( const std::span< const V > ordered_, const auto & summary_, const ordered::L_moment_kernel< V > & l_ ) {
+				[ & ]< std::size_t ...M >( std::index_sequence< M... > ){
+					( evaluate_if< F, M >( ordered_, summary_, l_, values_ ), ... );
+				}( std::make_index_sequence< metric_count >{} );
+			};
+
+			if constexpr( !needs_order< first_only > ) {
+				if( !acc_.is_ordered() ) {
+					const auto				unordered = acc_.unordered_values( first_only );
+					if constexpr( percentile_count< F > == 0 ) {
+						// Only counts: the number of values within the filter.
+						const V				count( detail::count_within( m_filters[ F ], unordered ) );
+						for( std::size_t m{}; m<metric_count; ++m )
+							if( Set::metrics[ m ].filter == F )		values_[ m_index[ m ] ] = count;
+					} else {
+						std::vector< V >	selected{};
+						detail::select_within( m_filters[ F ], unordered, percentiles< F >, selected );
+						evaluate_all( selected, Summary< V, 0 >{}, ordered::L_moment_kernel< V >{} );
+					}
+					return;
+				}
+			}
+
+			const std::span< const V >		ordered = acc_.ordered_span( m_filters[ F ] );
+			evaluate_all( ordered, detail::summary_of< summary_level< F > >( ordered ),
+				detail::L_moments( ordered, uses_L_moments< F, false >, uses_L_moments< F, true > ) );
+		}
+
+		template< std::size_t F, bool First_only >
+		void calculate_if( Point_aggregator & acc_, const std::span< V > values_ ) const {
+			if constexpr( set_filters[ F ].first_only() == First_only )	calculate< F >( acc_, values_ );
+		}
+
+	public:
+		/// A kernel for metrics_, if they are the metrics of Set (in any order) for some nilsson level.
+		/** The nilsson level is not known here, so the levels of the filters of metrics_ are tried.		**/
+		static std::optional< Fused_kernel > match( const std::span< const Function_filter > metrics_ ) {
+			if( metrics_.size() != metric_count )						return std::nullopt;
+
+			std::vector< metrics_value_type >	levels{ 0 };
+			for( const auto & metric : metrics_ )
+				if( std::isfinite( metric.filter().min_level() ) )	levels.push_back( metric.filter().min_level() );
+
+			for( const auto nilsson : levels ) {
+				const auto					filters = Set::filters( nilsson );
+				std::array< std::size_t, metric_count >	index{};
+				std::vector< bool >			used( metrics_.size(), false );
+				bool						ok{ true };
+				for( std::size_t m{}; ok && ( m<metric_count ); ++m ) {
+					const Function_filter	wanted{ Set::metrics[ m ].function, filters[ Set::metrics[ m ].filter ] };
+					const std::size_t		i = std::find( metrics_.begin(), metrics_.end(), wanted ) - metrics_.begin();
+					ok						  = ( i < metrics_.size() ) && !used[ i ];
+					if( ok )				used[ index[ m ] = i ] = true;
+				}
+				if( ok )					return Fused_kernel( nilsson, index );
+			}
+			return std::nullopt;
+		}
+
+		/// The number of metrics.
+		static constexpr std::size_t size()							  noexcept	{	return metric_count;		}
+
+		/// Calculate the metrics for acc_ and put them in values_, in the order of the metrics it was matched with.
+		void calculate( Point_aggregator & acc_, const std::span< V > values_ )	const {
+			// The filters of all points first, so the aggregator values are rearranged at most once.
+			[ & ]< std::size_t ...F >( std::index_sequence< F... > ){
+				( calculate_if< F, false >( acc_, values_ ), ... );
+				( calculate_if< F, true  >( acc_, values_ ), ... );
+			}( std::make_index_sequence< filter_count >{} );
+		}
+	};
+
+
+	/// Calculates a metric set: with a Fused_kernel if it is a preconfigured set, otherwise with a Metric_plan.
+	/** The results are the same either way. 																**/
+	class Metric_kernel {
+		using V							  = metrics_value_type;
+		using Kernel					  = std::variant<
+			Metric_plan, Fused_kernel< Basic_linear >, Fused_kernel< Inka_berries >, Fused_kernel< Extra_allt >
+		>;
+
+		std::string_view					m_name{};
+		Kernel								m_kernel;
+
+		template< typename Set, typename ...Sets >
+		static Kernel make( const std::span< const Function_filter > metrics_, std::string_view & name_ ) {
+			if( auto fused = Fused_kernel< Set >::match( metrics_ ) ) {
+				name_						  = Set::name;
+				return std::move( *fused );
+			}
+			if constexpr( sizeof...( Sets ) > 0 )	return make< Sets... >( metrics_, name_ );
+			else									return Metric_plan{ metrics_ };
+		}
+
+	public:
+		/// Prepare the calculation of metrics_.
+		explicit Metric_kernel( const std::span< const Function_filter > metrics_ )
+			: m_kernel{ make< Basic_linear, Inka_berries, Extra_allt >( metrics_, m_name ) } {}
+
+		/// The name of the preconfigured set, if a fused kernel is used. Otherwise empty.
+		std::string_view fused()							const noexcept	{	return m_name;			}
+
+		/// The number of metrics.
+		std::size_t size()									const noexcept	{
+			return std::visit( []( const auto & kernel_ ){ return kernel_.size(); }, m_kernel );
+		}
+
+		/// Calculate the metrics for acc_ and put them in values_, in the order of the metric set.
+		/// values_.size() must be size(). The aggregator is sorted if needed.
+		void calculate( Point_aggregator & acc_, const std::span< V > values_ )	const {
+			std::visit( [ & ]( const auto & kernel_ ){ kernel_.calculate( acc_, values_ ); }, m_kernel );
+		}
+
+		/// Calculate the metrics for acc_.
+		std::vector< V > operator()( Point_aggregator & acc_ )	const {
+			std::vector< V >				values( size() );
+			calculate( acc_, values );
+			return values;
+		}
+	};
+
+}	// namespace pax::metrics
@@ -0,0 +1,191 @@
+//	Copyright (c) 2014-2022, Peder Axensten, all rights reserved.
+//	Contact: peder ( at ) axensten.se
+
+
+#pragma once
+
+#include "function-filter.hpp"
+
+#include <algorithm>	// std::max, std::count_if, std::copy_if, std::sort, std::stable_partition, std::unique
+#include <array>
+#include <iterator>		// std::back_inserter
+#include <span>
+#include <utility>		// std::pair
+#include <vector>
+
+
+namespace pax::metrics {
+
+	namespace detail {
+		using V							  = metrics_value_type;
+
+		// The L-moments of ordered_ (and its TL-moments if TL_), in a single traversal. All NaN if not L_.
+		inline ordered::L_moment_kernel< V > L_moments( const std::span< const V > ordered_, const bool L_, const bool TL_ ) noexcept {
+			return L_ ? ordered::L_moment_kernel< V >( ordered_, TL_ ? Function::TL_trim : 0 ) : ordered::L_moment_kernel< V >{};
+		}
+
+		// The Summary of ordered_ with at least level L (0, 2, or 4).
+		template< std::size_t L >
+		auto summary_of( const std::span< const V > ordered_ ) noexcept {
+			if constexpr( L == 0 )			return Summary< V, 0 >{};
+			else if constexpr( L <= 2 )		return summary< 2 >( ordered_ );
+			else							return summary< 4 >( ordered_ );
+		}
+
+		// Is v_ within the levels of filter_? The same values as Point_aggregator::ordered_span( filter_ ).
+		constexpr auto within( const Filter filter_ ) noexcept {
+			return [ lo = filter_.min_level(), hi = filter_.max_level() ]( const V v_ ){ return !( v_ < lo ) && ( v_ < hi ); };
+		}
+
+		// The number of values within filter_, in linear time.
+		inline std::size_t count_within( const Filter filter_, const std::span< const V > unordered_ ) noexcept {
+			return std::count_if( unordered_.begin(), unordered_.end(), within( filter_ ) );
+		}
+
+		// Put the values within filter_ in selected_, partially ordered so that ordered::percentile( selected_, p )
+		// gives the same result as if they were sorted, for each p in percentiles_.
+		inline void select_within(
+			const Filter					filter_,
+			const std::span< const V >		unordered_,
+			const std::span< const std::size_t >	percentiles_,
+			std::vector< V >			  & selected_
+		) {
+			selected_.clear();
+			selected_.reserve( unordered_.size() );
+			std::copy_if( unordered_.begin(), unordered_.end(), std::back_inserter( selected_ ), within( filter_ ) );
+
+			// The ranks that ordered::quantile uses, for each percentile.
+			std::vector< std::size_t >		ranks{};
+			if( !selected_.empty() )
+				for( const std::size_t p : percentiles_ ) {
+					const auto [ r, fraction ]	= ordered::quantile_position< V >( selected_.size(), 0.01*p );
+					ranks.push_back( r );
+					if( r + 1 < selected_.size() )	ranks.push_back( r + 1 );
+				}
+			std::sort( ranks.begin(), ranks.end() );
+			ranks.erase( std::unique( ranks.begin(), ranks.end() ), ranks.end() );
+			select_ranks( std::span( selected_ ), std::span< const std::size_t >( ranks ) );
+		}
+	}
+
+
+	/// Calculates a set of metrics, sharing the work between metrics with the same filter.
+	/** Calling Function_filter::calculate for each metric narrows the aggregator values once per metric, and
+		e.g. mean, variance, and skewness of the same filter each go through the same values.
+		Here the metrics are grouped by filter and, for each group:
+		- the values are narrowed once,
+		- the Summary (of the highest level needed) is calculated once,
+		- the L-moments, their ratios, and the TL-moments are calculated once (see ordered::L_moment_kernel),
+		- and then each metric is calculated from those. 
+		
+		If no metric on all values (or on the first returns) needs them ordered, i.e. there are only counts and 
+		percentiles, they are not sorted. Instead, the values within the filter levels are counted in linear time and 
+		only the order statistics the percentiles use are selected (see select_ranks). The results are identical.	**/
+	class Metric_plan {
+		using V							  = metrics_value_type;
+
+		struct Group {
+			Filter							filter;
+			std::size_t						summary_level{};
+			bool							L_moments{};
+			bool							TL_moments{};
+			bool							percentiles{};
+			std::vector< std::pair< std::size_t, Function > >	functions{};	// Index in the metric set, and function.
+		};
+
+		std::vector< Group >				m_groups{};
+		std::size_t							m_size{};
+		std::array< bool, 2 >				m_needs_order{};		// For all values and for the first returns.
+
+		template< typename S >
+		static void evaluate(
+			const Group					  & group_,
+			const std::span< const V >		ordered_,
+			const S						  & summary_,
+			const std::span< V >			values_
+		) noexcept {
+			const auto						l = detail::L_moments( ordered_, group_.L_moments, group_.TL_moments );
+			for( const auto & [ i, function ] : group_.functions )
+				values_[ i ]			  = function( ordered_, summary_, l );
+		}
+
+		// The counts and percentiles of group_, from the values in no particular order.
+		static void select(
+			const Group					  & group_,
+			const std::span< const V >		unordered_,
+			const std::span< V >			values_
+		) {
+			if( !group_.percentiles ) {
+				const V						count( detail::count_within( group_.filter, unordered_ ) );
+				for( const auto & [ i, function ] : group_.functions )	values_[ i ] = count;
+				return;
+			}
+
+			std::vector< std::size_t >		percentiles{};
+			for( const auto & [ i, function ] : group_.functions )
+				if( const auto p = function.percentile() )		percentiles.push_back( *p );
+			std::vector< V >				selected{};
+			detail::select_within( group_.filter, unordered_, percentiles, selected );
+
+			const std::span< const V >		partial( selected );
+			for( const auto & [ i, function ] : group_.functions )
+				values_[ i ]			  = function( partial );
+		}
+
+	public:
+		Metric_plan()										  = default;
+
+		/// Plan the calculation of metrics_.
+		explicit Metric_plan( const std::span< const Function_filter > metrics_ ) : m_size{ metrics_.size() } {
+			for( std::size_t i{}; i<metrics_.size(); ++i ) {
+				const Filter				filter = metrics_[ i ].filter();
+				const Function				function = metrics_[ i ].function();
+				auto						group = std::find_if( m_groups.begin(), m_groups.end(),
+												[ filter ]( const Group & g_ ){ return g_.filter == filter; } );
+				if( group == m_groups.end() )	group = m_groups.insert( m_groups.end(), Group{ filter } );
+				group->summary_level	  = std::max( group->summary_level,  function.summary_level() );
+				group->L_moments		  = group->L_moments  || function.uses_L_moments();
+				group->TL_moments		  = group->TL_moments || function.uses_TL_moments();
+				group->percentiles		  = group->percentiles || function.percentile();
+				group->functions.emplace_back( i, function );
+				m_needs_order[ filter.first_only() ]	  = m_needs_order[ filter.first_only() ] || function.needs_order();
+			}
+
+			// The filters of all points first, so the aggregator values are rearranged at most once.
+			std::stable_partition( m_groups.begin(), m_groups.end(), []( const Group & g_ ){ return !g_.filter.first_only(); } );
+		}
+
+		/// The number of metrics.
+		std::size_t size()									const noexcept	{	return m_size;				}
+
+		/// The number of distinct filters.
+		std::size_t groups()								const noexcept	{	return m_groups.size();		}
+
+		/// Calculate the metrics for acc_ and put them in values_, in the order of the metric set.
+		/// values_.size() must be size(). Like Function_filter::calculate, the aggregator is sorted if needed.
+		void calculate( Point_aggregator & acc_, const std::span< V > values_ )	const {
+			for( const auto & group : m_groups ) {
+				const bool					first_only = group.filter.first_only();
+				if( !m_needs_order[ first_only ] && !acc_.is_ordered() ) {
+					select( group, acc_.unordered_values( first_only ), values_ );
+					continue;
+				}
+				const std::span< const V >	ordered = acc_.ordered_span( group.filter );
+				switch( group.summary_level ) {
+					case 0:		evaluate( group, ordered, detail::summary_of< 0 >( ordered ),	values_ );	break;
+					case 1:
+					case 2:		evaluate( group, ordered, detail::summary_of< 2 >( ordered ),	values_ );	break;
+					default:	evaluate( group, ordered, detail::summary_of< 4 >( ordered ),	values_ );	break;
+				}
+			}
+		}
+
+		/// Calculate the metrics for acc_.
+		std::vector< V > operator()( Point_aggregator & acc_ )	const {
+			std::vector< V >				values( m_size );
+			calculate( acc_, values );
+			return values;
+		}
+	};
+
+}	// namespace pax::metrics
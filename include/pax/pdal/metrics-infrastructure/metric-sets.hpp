@@ -0,0 +1,93 @@
+//	Copyright (c) 2014-2022, Peder Axensten, all rights reserved.
+//	Contact: peder ( at ) axensten.se
+
+
+#pragma once
+
+#include "filter.hpp"
+#include "function.hpp"
+
+#include <array>
+#include <string_view>
+
+
+namespace pax::metrics {
+
+	/// A metric of a preconfigured metric set: a function and the index of its filter in the set.
+	struct Metric_descriptor {
+		Function						function{ Function::count() };
+		std::size_t						filter{};
+	};
+
+
+	/// Compile-time descriptions of the preconfigured metric sets.
+	/** Each set has:
+		- name: the id of the set, as used by Function_filter::create_set.
+		- filters( nilsson_ ): the filters of the set, some of them depend on the nilsson level.
+		- metrics: the metrics of the set, as a function and the index of its filter.
+		The functions and what filters they use are known at compile time, so a Fused_kernel can be specialised for them. **/
+	struct Basic_linear {
+		static constexpr std::string_view	name{ "basic-linear" };
+
+		static constexpr std::array< Filter, 4 > filters( const metrics_value_type nilsson_ )	noexcept	{
+			return { Filter::all(), Filter::all_ge( nilsson_ ), Filter::ret1_ge( nilsson_ ), Filter::ret1() };
+		}
+
+		static constexpr std::array< Metric_descriptor, 7 >		metrics{ {
+			{ Function::count(),	0 },
+			{ Function::variance(),	1 },
+			{ Function::p( 30 ),	1 },
+			{ Function::p( 80 ),	1 },
+			{ Function::p( 95 ),	1 },
+			{ Function::count(),	2 },
+			{ Function::count(),	3 }
+		} };
+	};
+
+	struct Inka_berries {
+		static constexpr std::string_view	name{ "inka-berries" };
+
+		static constexpr std::array< Filter, 3 > filters( const metrics_value_type nilsson_ )	noexcept	{
+			return { Filter::all(), Filter::ret1_ge( nilsson_ ), Filter::ret1() };
+		}
+
+		static constexpr std::array< Metric_descriptor, 5 >		metrics{ {
+			{ Function::L3(),		0 },
+			{ Function::p( 30 ),	0 },
+			{ Function::count(),	1 },
+			{ Function::count(),	2 },
+			{ Function::mean2(),	2 }
+		} };
+	};
+
+	struct Extra_allt {
+		static constexpr std::string_view	name{ "extra-allt" };
+
+		static constexpr std::array< Filter, 10 > filters( const metrics_value_type nilsson_ )	noexcept	{
+			return {
+				Filter:: all_ge( 5 ), Filter:: all_ge( 10 ), Filter:: all_ge( 15 ),
+				Filter::ret1_ge( 5 ), Filter::ret1_ge( 10 ), Filter::ret1_ge( 15 ),
+				Filter::all(),		Filter::all_ge( nilsson_ ),
+				Filter::ret1(),		Filter::ret1_ge( nilsson_ )
+			};
+		}
+
+		// Counts for the first six filters, and all the functions for the last four.
+		static constexpr std::array< Metric_descriptor, 6 + 20*4 >	metrics = []{
+			constexpr Function			functions[] = {
+				Function::count(),	Function::mean(),	Function::mean2(),	Function::variance(),
+				Function::skewness(),					Function::kurtosis(),
+				Function::p( 10 ),	Function::p( 20 ),	Function::p( 30 ),	Function::p( 40 ),	Function::p( 50 ),
+				Function::p( 60 ),	Function::p( 70 ),	Function::p( 80 ),	Function::p( 90 ),	Function::p( 95 ),
+				Function::L2(),   	Function::L3(),   	Function::L4(),   	Function::mad()
+			};
+			std::array< Metric_descriptor, 6 + 20*4 >	result{};
+			std::size_t					m{};
+			for( std::size_t f{}; f<6; ++f )	result[ m++ ] = { Function::count(), f };
+			for( const Function function : functions )
+				for( std::size_t f{ 6 }; f<10; ++f )	result[ m++ ] = { function, f };
+			return result;
+		}();
+	};
+
+}	// namespace pax::metrics
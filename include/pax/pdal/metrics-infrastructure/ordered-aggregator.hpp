@@ -4,7 +4,11 @@
 
 #pragma once
 
+#include <pax/std/radix-sort.hpp>
+
 #include <cassert>
+#include <memory>		// std::allocator
+#include <memory_resource>
 #include <span>
 #include <vector>
 #include <algorithm>
@@ -17,20 +21,25 @@ namespace pax {
 		If you repeatedly add some values and want ordered access to them before adding more, use this container.
 		- The container is not (for efficiency reasons) in an ordered state after every insert. 
 		- Access to elements are only through std::span(). This is to ensure that access is always to sorted elements.
+		- With an Allocator, e.g. std::pmr::polymorphic_allocator, the values may be kept in an arena (see Arena_resource).
 	**/
-	template< std::floating_point T >
-	class Ordered_vector : std::vector< T > {
+	template< std::floating_point T, typename Allocator = std::allocator< T > >
+	class Ordered_vector : std::vector< T, Allocator > {
 	private:
-		using Base						  = std::vector< T >;
+		using Base						  = std::vector< T, Allocator >;
 		std::size_t							m_ordered{};
 
-		constexpr bool is_ordered()								const noexcept	{	return m_ordered == Base::size();	}
+		// The memory resource of the values, if they have one, for the scratch buffer of sort.
+		std::pmr::memory_resource * resource()						const noexcept	{
+			if constexpr( requires{ Base::get_allocator().resource(); } )	return Base::get_allocator().resource();
+			else											return std::pmr::get_default_resource();
+		}
 
-		/// Sort the container (you need rarely to call this, as span() does it).
-		constexpr void order()										  noexcept	{
+		/// Sort the container (you need rarely to call this, as span() does it). Allocates scratch memory.
+		constexpr void order()													{
 			if( !is_ordered() ) {
 				// Order the trailing set (values recently pushed).
-				std::sort( Base::begin() + m_ordered, Base::end() );
+				sort( { Base::data() + m_ordered, Base::size() - m_ordered }, resource() );
 
 				// Merge the main and trailing sets.
 				std::inplace_merge( Base::begin(), Base::begin() + m_ordered, Base::end() );
@@ -41,7 +50,22 @@ namespace pax {
 		}
 
 	public:
+		/// From this many values recently pushed, they are ordered by radix_sort instead of std::sort.
+		static constexpr std::size_t		radix_sort_threshold{ 256 };
+
+		/// Sort sp_, by radix_sort if there are enough values (of float or double).
+		/// The scratch buffer of radix_sort is allocated from resource_.
+		static constexpr void sort( 
+			const std::span< T >			sp_, 
+			std::pmr::memory_resource	  * resource_ = std::pmr::get_default_resource() 
+		) {
+			if constexpr( std::same_as< T, float > || std::same_as< T, double > )
+				if( sp_.size() >= radix_sort_threshold )	return radix_sort( sp_, resource_ );
+			std::sort( sp_.begin(), sp_.end() );
+		}
+
 		using value_type				  = const T;
+		using allocator_type			  = Allocator;
 		using Base::empty;
 		using Base::size;
 		using Base::reserve;
@@ -55,8 +79,10 @@ namespace pax {
 		constexpr Ordered_vector & operator=( const Ordered_vector & )	=	default;
 		constexpr Ordered_vector & operator=( Ordered_vector && ) 		=	default;
 
+		explicit constexpr Ordered_vector( const Allocator & alloc_ ) noexcept : Base{ alloc_ } {}
+
 		template< std::floating_point U, std::size_t N >
-		explicit constexpr Ordered_vector( const std::span< U, N > data_ ) : Base{}		{
+		explicit constexpr Ordered_vector( const std::span< U, N > data_, const Allocator & alloc_ = Allocator{} ) : Base{ alloc_ }	{
 			push_back( data_ );
 			order();		// In case we want to create a const Ordered_vector.
 		}
@@ -67,12 +93,33 @@ namespace pax {
 			Base::insert( Base::end(), data_.begin(), data_.end() );
 		}
 
-		/// Get a span of the [sorted] container elements.
-		constexpr std::span< value_type > ordered_span()		 	   		  noexcept	{
+		/// Add the values of other_ and order them all, in linear time if both containers are ordered.
+		constexpr Ordered_vector & merge( const Ordered_vector & other_ )					{
+			if( this == &other_ )		return merge( Ordered_vector( other_ ) );
+			order();
+			const std::size_t			middle = Base::size();
+			Base::insert( Base::end(), other_.Base::begin(), other_.Base::end() );
+			if( !other_.is_ordered() )	sort( { Base::data() + middle, Base::size() - middle }, resource() );
+			std::inplace_merge( Base::begin(), Base::begin() + middle, Base::end() );
+			m_ordered				  = Base::size();
+			return *this;
+		}
+
+		/// Get a span of the [sorted] container elements. Sorting allocates scratch memory.
+		constexpr std::span< value_type > ordered_span()		 	   					{
 			order();
 			return { Base::data(), Base::size() };
 		}
 
+		/// Is the container in an ordered state?
+		constexpr bool is_ordered()								const noexcept	{	return m_ordered == Base::size();	}
+
+		/// Get a span of the container elements, in no particular order. 
+		/** For when the order does not matter, or when only a few order statistics are needed (see select_ranks). **/
+		constexpr std::span< value_type > unordered_span()				const noexcept	{
+			return { Base::data(), Base::size() };
+		}
+
 		/// If sorted, get a span of the container elements. Throws, otherwise. 
 		constexpr std::span< value_type > ordered_span()				const noexcept	{
 			assert( is_ordered() && "Ordered_vector: ordered access needed, but const container is not ordered" );
@@ -83,16 +130,16 @@ namespace pax {
 
 	template< typename T >	struct Serialize;
 
-	template< typename T >
-	struct Serialize< Ordered_vector< T > > : Serialize< std::vector< T > > {
+	template< typename T, typename Allocator >
+	struct Serialize< Ordered_vector< T, Allocator > > : Serialize< std::vector< T, Allocator > > {
 		template< typename ...Format >
-		static auto to_string( std::vector< T > & ov_, Format && ...fmt_ ) {
+		static auto to_string( std::vector< T, Allocator > & ov_, Format && ...fmt_ ) {
 			ov_.order();
 			return to_string_container( ov_ , std::forward< Format >( fmt_ )... );
 		}
 
 		template< typename ...Format >
-		static auto to_string( const std::vector< T > & ov_, Format && ...fmt_ ) {
+		static auto to_string( const std::vector< T, Allocator > & ov_, Format && ...fmt_ ) {
 			return to_string_container( ov_ , std::forward< Format >( fmt_ )... );
 		}
 	};
@@ -8,14 +8,37 @@
 #include "ordered-aggregator.hpp"
 #include <pax/math/metrics/ordered.hpp>
 
+#include <algorithm>	// std::copy, std::count, std::fill, std::rotate, std::set_difference
+#include <iterator>	// std::back_inserter
+#include <memory_resource>
+#include <vector>
+
 
 namespace pax::metrics {
 
+	/// Aggregates the z values of points, so that the values of any Filter can be had as an ordered span.
+	/** Each value is kept once, with a bit that tells if it is a first return. Arranged values are either:
+		- merged: all values are ordered (for the filters of all points), or
+		- split: the first returns and then the other values, each part ordered (for the filters of first returns).
+		The arrangement is changed in linear time when the other kind of filter is asked for.			**/
 	class Point_aggregator {
-		Ordered_vector< metrics_value_type >	m_all{}, m_firsts{};
-		
+	public:
+		/// The values are allocated from a std::pmr::memory_resource, by default new and delete.
+		using allocator_type			  = std::pmr::polymorphic_allocator< metrics_value_type >;
+		using value_type				  = metrics_value_type;
+
+	private:
+		using V							  = metrics_value_type;
+
+		std::pmr::vector< V >				m_values{};
+		std::pmr::vector< bool >			m_first{};		// Is m_values[ i ] a first return?
+		std::size_t							m_head{};		// The values before this are arranged, the others are pushed since.
+		std::size_t							m_firsts{};		// The number of first returns among the arranged values.
+		bool								m_ordered{ true };	// Are the arranged values ordered?
+		bool								m_merged{};		// Are the arranged values merged (or split)?
+
 		constexpr auto narrow(
-			const Filter						  & filter_, 
+			const Filter						  & filter_,
 			std::span< const metrics_value_type >	data_
 		) const noexcept {
 			// Keep only values belove the max level.
@@ -25,56 +48,228 @@ namespace pax::metrics {
 			return data_;
 		}
 
-	public:
-		using value_type = std::remove_const_t< typename Ordered_vector< metrics_value_type >::value_type >;
+		std::span< V > values( const std::size_t begin_, const std::size_t end_ )	noexcept	{
+			return { m_values.data() + begin_, end_ - begin_ };
+		}
+
+		// The memory resource of the values, also for scratch buffers (an arena reuses them).
+		std::pmr::memory_resource * resource()				const noexcept	{
+			return m_values.get_allocator().resource();
+		}
+
+		// A scratch buffer, from the memory resource of the values.
+		std::pmr::vector< V > buffer()						const			{
+			return std::pmr::vector< V >( resource() );
+		}
 
+		// Sort sp_, with any scratch buffer from the memory resource of the values.
+		void sort( const std::span< V > sp_ )				const			{
+			Ordered_vector< V >::sort( sp_, resource() );
+		}
+
+		// Stably move the first returns among values [begin_, end_) before the others. Returns how many they are.
+		std::size_t partition( const std::size_t begin_, const std::size_t end_ ) {
+			std::pmr::vector< V >			others = buffer();
+			others.reserve( std::count( m_first.begin() + begin_, m_first.begin() + end_, false ) );
+			std::size_t						w{ begin_ };
+			for( std::size_t i{ begin_ }; i<end_; ++i )
+				if( m_first[ i ] )			m_values[ w++ ] = m_values[ i ];
+				else						others.push_back( m_values[ i ] );
+			std::copy( others.begin(), others.end(), m_values.begin() + w );
+			std::fill( m_first.begin() + begin_, m_first.begin() + w, true );
+			std::fill( m_first.begin() + w, m_first.begin() + end_, false );
+			return w - begin_;
+		}
+
+		// Are the arranged values arranged for filters of first returns (split), or of all points (merged)?
+		// With no first returns, or only first returns, the two arrangements are the same.
+		bool arranged_for( const bool first_only_ )			const noexcept	{
+			return ( first_only_ != m_merged ) || ( m_firsts == 0 ) || ( m_firsts == m_head );
+		}
+
+		// Split the arranged values: the first returns and then the others.
+		void split() {
+			if( m_merged ) {
+				partition( 0, m_head );
+				m_merged				  = false;
+			}
+		}
+
+		// Merge the ordered values [begin_, middle_) and [middle_, end_). Stable, like std::inplace_merge.
+		// Only the first part is copied to a buffer: writing from the front never overtakes the second part.
+		// If first_, set m_first of the merged values: the first part is the first returns and the second part the others.
+		void merge_ordered( const std::size_t begin_, const std::size_t middle_, const std::size_t end_, const bool first_ = false ) {
+			std::pmr::vector< V >			left = buffer();
+			left.assign( m_values.begin() + begin_, m_values.begin() + middle_ );
+			std::size_t						i{}, j{ middle_ }, k{ begin_ };
+			while( i < left.size() ) {
+				const bool					from_left = ( j == end_ ) || !( m_values[ j ] < left[ i ] );
+				if( first_ )				m_first[ k ] = from_left;
+				m_values[ k++ ]			  = from_left ? left[ i++ ] : m_values[ j++ ];
+			}
+			// The rest of the second part is already in place (and not first returns).
+		}
+
+		// Merge the (ordered and split) arranged values.
+		void merge_arranged() {
+			if( m_merged )					return;
+			merge_ordered( 0, m_firsts, m_head, true );
+			m_merged					  = true;
+		}
+
+		// Arrange the values pushed since: split, and ordered if the arranged values are (and there are any).
+		// Then order all values, if order_. If pushed_ordered_, the pushed first returns and others are already ordered.
+		void arrange( const bool order_, const bool pushed_ordered_ = false ) {
+			const std::size_t				size = m_values.size();
+			if( m_head < size ) {
+				split();
+				const bool					ordered = m_ordered && ( order_ || m_head );
+				const std::size_t			firsts = partition( m_head, size );		// [ F1 | O1 | F2 | O2 ]
+				const std::size_t			f = m_firsts + firsts, o = m_head + firsts;
+
+				// Then [ F1 | F2 | O1 | O2 ].
+				std::rotate( m_values.begin() + m_firsts, m_values.begin() + m_head, m_values.begin() + m_head + firsts );
+				std::fill( m_first.begin() + m_firsts, m_first.begin() + f, true );
+				std::fill( m_first.begin() + f, m_first.end(), false );
+				if( ordered ) {
+					if( !pushed_ordered_ ) {
+						sort( values( m_firsts, f ) );
+						sort( values( o, size ) );
+					}
+					merge_ordered( 0, m_firsts, f );
+					merge_ordered( f, o,        size );
+				}
+				m_ordered				  = ordered;
+				m_firsts				  = f;
+				m_head					  = size;
+			}
+			if( order_ && !m_ordered ) {
+				split();
+				sort( values( 0, m_firsts ) );
+				sort( values( m_firsts, m_head ) );
+				m_ordered				  = true;
+			}
+		}
+
+	public:
 		Point_aggregator()											=	default;
+
+		/// Allocate the values from resource_, e.g. an Arena_resource shared by many aggregators.
+		/** The resource must outlive the aggregator. Copies of the aggregator use the default resource.	**/
+		explicit Point_aggregator( std::pmr::memory_resource * resource_ ) noexcept
+			: m_values{ allocator_type( resource_ ) }, m_first{ std::pmr::polymorphic_allocator< bool >( resource_ ) } {}
+
 		Point_aggregator( const Point_aggregator & )				=	default;
 		Point_aggregator( Point_aggregator && )						=	default;
 		Point_aggregator & operator=( const Point_aggregator & )	=	default;
 		Point_aggregator & operator=( Point_aggregator && )			=	default;
 
-		/// Ordinary number are treated as points with no first returns. 
+		/// Ordinary number are treated as points with no first returns.
 		template< std::floating_point T, std::size_t N >
-		Point_aggregator( const std::span< T, N > data_ ) : m_all{ data_ }, m_firsts{} {}
+		Point_aggregator( const std::span< T, N > data_ ) : m_values( data_.begin(), data_.end() ), m_first( data_.size(), false ) {
+			arrange( true );
+		}
 
-		/// Push a value. 
+		/// Push a value.
 		void push_back(
-			const value_type		z_, 
+			const value_type		z_,
 			const bool				is_first_return_
 		) {
-			m_all.push_back( z_ );
-			if( is_first_return_ )	m_firsts.push_back( z_ );
+			m_values.push_back( z_ );
+			m_first .push_back( is_first_return_ );
 		}
 
-		/// Push another point. 
+		/// Push another point.
 		template< typename Pt >
 		void push_back( const Pt & pt_ )			{
 			push_back( height( pt_ ), is_first_return( pt_ ) );
 		}
 
-		auto empty()										const noexcept	{	return m_all.empty();		}
+		/// Push a bunch of values, where firsts_ are the first returns among all_.
+		template< std::floating_point T, std::size_t N, std::size_t M >
+		void push_back(
+			const std::span< T, N >	all_,
+			const std::span< T, M >	firsts_
+		) {
+			std::pmr::vector< V >			all = buffer(), firsts = buffer(), others = buffer();
+			all   .assign( all_   .begin(), all_   .end() );
+			firsts.assign( firsts_.begin(), firsts_.end() );
+			sort( all );
+			sort( firsts );
+			std::set_difference( all.begin(), all.end(), firsts.begin(), firsts.end(), std::back_inserter( others ) );
+			for( const V z : firsts )		push_back( z, true );
+			for( const V z : others )		push_back( z, false );
+		}
+
+		/// Add the values of other_, as if its points were pushed here.
+		/** E.g. the values of the parts of a plot in different tiles or of different threads.
+			The metrics are the same as if all points were pushed to a single aggregator.
+			If other_ is ordered, its values are merged in linear time.										**/
+		Point_aggregator & merge( const Point_aggregator & other_ ) {
+			if( this == &other_ )			return merge( Point_aggregator( other_ ) );
+			arrange( true );
+			m_values.insert( m_values.end(), other_.m_values.begin(), other_.m_values.end() );
+			m_first .insert( m_first .end(), other_.m_first .begin(), other_.m_first .end() );
+			arrange( true, other_.is_ordered() );
+			return *this;
+		}
+
+		/// Same as merge( other_ ).
+		Point_aggregator & operator+=( const Point_aggregator & other_ )	{	return merge( other_ );	}
+
+		auto empty()										const noexcept	{	return m_values.empty();	}
 
 		void reserve( std::size_t capacity_ )		{
-			m_all   .reserve( capacity_ );	
-			m_firsts.reserve( capacity_ );
+			m_values.reserve( capacity_ );
+			m_first .reserve( capacity_ );
 		}
 
 		void shrink_to_fit()						{
-			m_all   .shrink_to_fit();	
-			m_firsts.shrink_to_fit();
+			m_values.shrink_to_fit();
+			m_first .shrink_to_fit();
+		}
+
+		/// Return a std::span of z values as specified by filter_.
+		/** Warning: if you push more points, or ask for values of the other kind of filter (all points or first returns),
+			you might invalidate the returned std::span!														**/
+		auto ordered_span( const Filter filter_ )								{
+			return narrow( filter_, ordered_values( filter_.first_only() ) );
+		}
+
+		/// Return a std::span of all z values, or of the first returns, without any level limits.
+		/** Warning: if you push more points, or ask for the values of the other kind, you might invalidate the returned std::span!	**/
+		std::span< const V > ordered_values( const bool first_only_ )				{
+			arrange( true );
+			if( first_only_ ) {
+				split();
+				return { m_values.data(), m_firsts };
+			}
+			merge_arranged();
+			return m_values;
+		}
+
+		/// Are the z values in an ordered state?
+		/** Then the values of both kinds of filter (all points and first returns) are ordered, 
+			at most a linear rearrangement away (see ordered_values).											**/
+		bool is_ordered()									const noexcept	{
+			return m_ordered && ( m_head == m_values.size() );
 		}
 
-		/// Return a std::span of z values as specified by filter_. 
-		/** Warning: if you push more points you might invalidate the returned std::span!	**/
-		auto ordered_span( const Filter filter_ )				  noexcept	{
-			return narrow( filter_, filter_.first_only() ? m_firsts.ordered_span() : m_all.ordered_span() );
+		/// Return a std::span of all z values, or of the first returns, in no particular order and without any level limits.
+		/** Warning: if you push more points, or ask for the values of the other kind, you might invalidate the returned std::span!	**/
+		std::span< const V > unordered_values( const bool first_only_ )			{
+			if( !first_only_ )				return m_values;
+			arrange( false );
+			split();
+			return { m_values.data(), m_firsts };
 		}
 
-		/// Return a std::span of z values as specified by filter_. 
-		/** Warning: if you push more points you might invalidate the returned std::span!	**/
-		auto ordered_span( const Filter filter_ )			const			{
-			return narrow( filter_, filter_.first_only() ? m_firsts.ordered_span() : m_all.ordered_span() );
+		/// Return a std::span of z values as specified by filter_.
+		/** The values must be ordered and arranged for the kind of filter_, e.g. by a call to the non-const ordered_span.	**/
+		std::span< const V > ordered_span( const Filter filter_ )	const noexcept	{
+			assert( is_ordered() && arranged_for( filter_.first_only() )
+				&& "Point_aggregator: ordered access needed, but const aggregator is not arranged for it" );
+			return narrow( filter_, { m_values.data(), filter_.first_only() ? m_firsts : m_values.size() } );
 		}
 	};
 
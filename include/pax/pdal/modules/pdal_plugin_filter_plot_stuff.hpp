@@ -4,11 +4,14 @@
 
 #include <pax/tables/text-table.hpp>	// Handle a csv file.
 #include <pax/types/point-stuff/circle.hpp>
+#include <pax/types/point-stuff/circle-index.hpp>
 #include <pax/pdal/metrics-infrastructure/function-filter.hpp>
+#include <pax/std/delta-varint.hpp>
 
 #include <pdal/Filter.hpp>
-// #include <pdal/Streamable.hpp>
+#include <pdal/Streamable.hpp>
 
+#include <functional>	// std::function
 #include <string>
 #include <string_view>
 #include <vector>
@@ -16,14 +19,27 @@
 
 namespace pax {
 
+	/// How to keep copies of points, when there is no view to keep point ids into (i.e. when streaming).
+	struct Point_packing {
+		pdal::PointLayoutPtr				layout{};		// The layout of the points.
+		pdal::DimTypeList					dims{};			// The dimensions to pack, all of them.
+		std::size_t							size{};			// Bytes per packed point.
+		pdal::SpatialReference				srs{};			// To give the saved point clouds.
+	};
+
+
 	/// A simple container for the spacial data of a plot.
 	/// It has the plot stuff + an id and a vector of pdal points. 
+	/// Metrics may be aggregated for several concentric radii, the plot circle is then the largest of them.
 	class Plot_w_points : public Circle_w_id< double, 2 > {
 		using Plot_w_id					  = Circle_w_id< double, 2 >;
-		static_assert( sizeof( pdal::PointId ) == 8 );
 
-		std::vector< pdal::PointId >		m_points_idx{};
-		metrics::Point_aggregator			m_metric_agg{};
+		// The ids arrive in increasing order, so they are stored as varint deltas: mostly a byte each instead of eight.
+		Delta_varint_vector< pdal::PointId >	m_points_idx{};
+		std::vector< char >					m_packed{};			// Used instead of m_points_idx, if m_packing.
+		const Point_packing				  * m_packing{};
+		std::vector< metrics::Point_aggregator >	m_metric_aggs{};	// One for each radius.
+		std::vector< coord_type >			m_radii2{};			// The squared radii to aggregate metrics for.
 		pdal::Dimension::Id					m_height_dimension{ pdal::Dimension::Id::Z };
 		bool								m_do_metrics{}, m_do_points{}, m_has_return_number{};
 
@@ -37,35 +53,48 @@ namespace pax {
 		constexpr Plot_w_points & operator=( Plot_w_points && )		  = default;
 
 		/// The actual constructor. 
-		constexpr Plot_w_points(
+		/// Metrics are aggregated for each of radii_, or for the plot radius if radii_ is empty.
+		Plot_w_points(
 			const Plot_w_id				  & plot_,
+			const std::span< const coord_type >	radii_,
 			const bool						do_metrics, 
 			const bool						do_points, 
 			const bool						has_return_number,
-			const pdal::Dimension::Id		height_dimension
-		) noexcept : 
+			const pdal::Dimension::Id		height_dimension,
+			const Point_packing			  * packing = nullptr
+		) : 
 			Plot_w_id					  { plot_ 				},
+			m_packing					  { packing				},
+			m_metric_aggs				  ( std::max( std::size_t( 1 ), radii_.size() ) ),
 			m_height_dimension			  { height_dimension	}, 
 			m_do_metrics				  { do_metrics			},
 			m_do_points					  { do_points			},
 			m_has_return_number			  { has_return_number	}
-		{}
+		{
+			if( radii_.empty() )			m_radii2.push_back( plot_.radius()*plot_.radius() );
+			for( const auto r : radii_ )	m_radii2.push_back( r*r );
+		}
 
 		/// Process a point. Return true if it was inside the plot.
 		bool process( const pdal::PointRef & pt_ ) 			noexcept;
 
 		/// Number of point so far accumulated.
-		std::size_t num_of_points()							const noexcept	{	return m_points_idx.size();		}
-
-		/// Access the metrics aggregator.
-		/// Calculating the metrics mutates the aggregator (the z-values are sorted in place), so no 'const'. 
-		metrics::Point_aggregator & metric_aggregator()		noexcept		{	return m_metric_agg;			}
-
-		/// Save the points of each found plot.
-		void save_plot_points( 
+		std::size_t num_of_points()							const noexcept	{
+			return m_packing ? m_packed.size()/m_packing->size : m_points_idx.size();
+		}
+
+		/// Access the metrics aggregators, one for each radius.
+		/// Calculating the metrics mutates the aggregators (the z-values are sorted in place), so no 'const'. 
+		std::span< metrics::Point_aggregator > metric_aggregators()	noexcept	{	return m_metric_aggs;	}
+
+		/// Append the points of the plot to dest_, a view with the dimensions dims_.
+		/// dims_ are the same dimensions, in the same order, as src_dims_ (the dimensions of view_ptr_ or of the packing).
+		/// view_ptr_ is the view the point ids refer to. It is not used if the points are packed.
+		void append_points( 
 			const pdal::PointViewPtr	  & view_ptr_,
-			const dir_path				  & plot_points_dest_dir_,
-			std::string_view				plot_points_file_format_
+			const pdal::DimTypeList		  & src_dims_,
+			const pdal::DimTypeList		  & dims_,
+			pdal::PointView				  & dest_
 		) const;
 	};
 
@@ -73,7 +102,8 @@ namespace pax {
 
 
 	/// Process point cloud files into individual plot point cloud files. 
-	class PDAL_DLL plot_stuff : public pdal::Filter/*, public pdal::Streamable*/ {
+	/// It is streamable, then the plots are selected by the header bounds or the argument 'bounds'.
+	class PDAL_DLL plot_stuff : public pdal::Filter, public pdal::Streamable {
 	public:
 		plot_stuff()									  = default;
 		plot_stuff( const plot_stuff & )				  = delete;
@@ -88,37 +118,56 @@ namespace pax {
 		using coordinate_type	  = double;
 		using value_type		  = float;
 
-		std::vector< Plot_w_points > get_plots( pdal::PointViewPtr );
+		std::vector< Plot_w_points > get_plots( const Box< double, 2 > &, const pdal::PointLayoutPtr & );
 		void setting_needs_PointView( pdal::PointViewPtr );
 		void addArgs( pdal::ProgramArgs & )					override;
 		void prepared( pdal::PointTableRef table_ )			override;
 	    void ready( pdal::PointTableRef table_ )			override;
-		bool processOne( pdal::PointRef & pt_ );//				override;
-	    // void filter( pdal::PointView & view_ )				override;
+		bool processOne( pdal::PointRef & pt_ )				override;
 		pdal::PointViewSet run( pdal::PointViewPtr view_ )	override;
 		void done( pdal::PointTableRef table_ )				override;
+		void save_plot_points( 
+			std::span< const Plot_w_points >	plots_,
+			const dir_path					  & dir_,
+			const std::function< void( const std::string &, const std::filesystem::path & ) > & saved_
+		) const;
 
 		std::string					m_plot_file{}, 
 									m_metrics_dest{}, 
+									m_partials_dest{}, 
 									m_points_dest_dir{}, 
-									m_id_column{}, 
+									m_points_archive{}, 
+									m_id_column{ "id" }, 
 									m_points_format{ ".laz" };
 		Text_table< char >			m_all_plots_table{};
 		double						m_plot_buffer{ 0.0 };
+		std::vector< double >		m_plot_radii{};	// Concentric radii to calculate metrics for, zero is the plot radius.
+		pdal::BOX2D					m_bounds{};		// Only used when streaming.
+		std::size_t					m_threads{ 1 };	// When saving plot point clouds.
 		pdal::StringList			m_metrics;		// Metric accessor names.
 		double						m_metrics_nilsson{ 0.0 };
 		
-		pdal::PointViewPtr			m_view_ptr{};
+		pdal::PointViewPtr			m_view_ptr{};	// Not used when streaming.
+		Point_packing				m_packing{};	// Only used when streaming.
+		bool						m_streaming{ false };
 		std::vector< Plot_w_points >	m_plots{};		// Binary "table" of plots.
+		std::size_t					m_full_plots{};	// The first plots are within the point cloud, the rest partially.
+		Circle_index< double, 2 >	m_plot_index{};	// What plots might contain a point?
 		
 		struct metadata {
 			std::size_t 			points_processed{}, 
-									points_in_plots{};
+									points_in_plots{},
+									plots_archived{};
 		};
 		mutable metadata			m_metadata{};
 		
 		bool do_metrics()			const noexcept	{	return !m_metrics_dest.empty();		}
-		bool do_points()			const noexcept	{	return !m_points_dest_dir.empty();	}
+		bool do_points()			const noexcept	{	return !m_points_dest_dir.empty() || !m_points_archive.empty();	}
+		bool do_partials()			const noexcept	{	return !m_partials_dest.empty();	}
+		bool do_plots()				const noexcept	{	return do_metrics() || do_points() || do_partials();	}
+		std::vector< std::string > radius_suffixes()	const;
+
+		std::span< Plot_w_points > full_plots()		noexcept	{	return std::span( m_plots ).first( m_full_plots );	}
 		
 	};
 
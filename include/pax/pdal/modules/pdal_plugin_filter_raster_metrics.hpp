@@ -3,7 +3,9 @@
 #pragma once
 
 #include <pax/pdal/metrics-infrastructure/function-filter.hpp>	// Point_aggregator, Function_filter
+#include <pax/pdal/metrics-infrastructure/height-histogram.hpp>	// Height_histograms
 #include <pax/types/point-stuff/box.hpp>						// Box_indexer
+#include <pax/std/arena.hpp>									// Arena_resource
 #include <pdal/Filter.hpp>
 // #include <pdal/Streamable.hpp>
 #include <string>
@@ -46,7 +48,7 @@ namespace pax {
 		raster_metrics & operator=( const raster_metrics & )	  = delete;
 		raster_metrics & operator=( raster_metrics && )			  = delete;
 
-		virtual ~raster_metrics() {};
+		virtual ~raster_metrics();
 		std::string getName()										const override;
 
 	private:
@@ -75,7 +77,10 @@ namespace pax {
 	    pdal::SpatialReference			m_srs{};
 		
 		// For processing:
+		Arena_resource					pr_arena{ Arena_resource::default_page_size, true };	// Must outlive pr_z_accumulators.
 		std::vector< metrics::Point_aggregator >	pr_z_accumulators;
+		metrics::Height_histograms		pr_histograms{};		// Used instead of pr_z_accumulators if all metrics are counts.
+		bool							pr_counts_only{};
 		std::vector< metrics::Function_filter >		pr_metrics_set{};
 		pdal::Dimension::Id 			pr_height_dimension{};
 		bool 							pr_has_return_number{};
@@ -8,13 +8,14 @@ namespace pax {
 	class PDAL_DLL Remove_overlap : public pdal::Filter {
 	public:
 		using pdal::Filter::Filter;
+		virtual ~Remove_overlap();
 		std::string getName() 										const override;
 
-	private:
 		using coordinate_type		  = double;
 		using angle_type			  = int32_t;	// actually int8_t in asprs
 		using source_id_type		  = uint32_t;	// actually uint16_t in asprs
 
+		/// Keeps track of the source id of the point with the smallest absolute scan angle in a pixel.
 		class Angle_source {
 			angle_type					m_angle{ std::numeric_limits< angle_type >::max() };
 			source_id_type				m_source_id{};
@@ -34,6 +35,7 @@ namespace pax {
 			constexpr source_id_type source_id()	const noexcept	{	return m_source_id;	}
 		};
 
+	private:
 		coordinate_type		m_overlap_resolution{ 0.0 };
 
 		void addArgs( pdal::ProgramArgs & args_ )					override;
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <pax/pdal/utilities/dem.hpp>
+
+#include <pdal/Filter.hpp>
+#include <pdal/Streamable.hpp>
+
+
+namespace pax {
+
+	class PDAL_DLL slu_hag : public pdal::Filter, public pdal::Streamable {
+	public:
+		slu_hag()											  = default;
+		slu_hag( const slu_hag & )							  = delete;
+		slu_hag( slu_hag &&)								  = delete;
+		slu_hag & operator=( const slu_hag & )				  = delete;
+		slu_hag & operator=( slu_hag && )					  = delete;
+
+		virtual ~slu_hag() {};
+
+		using pdal::Filter::Filter;
+		std::string getName() 									const override;
+
+	private:
+		void addArgs( pdal::ProgramArgs & args_ )				override;
+		void addDimensions( pdal::PointLayoutPtr layout_ )		override;
+	    void ready( pdal::PointTableRef table_ )				override;
+		bool processOne( pdal::PointRef & pt_ )					override;
+		void filter( pdal::PointView & view_ )					override;
+		void done( pdal::PointTableRef )						override;
+
+		using coordinate_type		  = double;
+
+		std::string			m_raster{};
+		int					m_band{ 1 };
+		Dem_cache			m_dem{};
+		std::size_t			m_points{}, m_no_ground{};
+	};
+
+} // namespace pax
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <pax/pdal/utilities/z-class-filter.hpp>
+
 #include <pdal/Filter.hpp>
 #include <pdal/Streamable.hpp>
 
@@ -14,7 +16,7 @@ namespace pax {
 		slu_lm & operator=( const slu_lm & )				  = delete;
 		slu_lm & operator=( slu_lm && )						  = delete;
 
-		virtual ~slu_lm() {};
+		virtual ~slu_lm();
 
 		using pdal::Filter::Filter;
 		std::string getName() 									const override;
@@ -27,19 +29,10 @@ namespace pax {
 		pdal::PointViewSet run( pdal::PointViewPtr view_ )		override;
 		void done( pdal::PointTableRef )						override;
 
-		using coordinate_type		  = double;
-		
-		struct metadata {
-			std::size_t 	points_in{}, points_out{};
-			std::size_t 	z_negative{}, z_small{}, z_large{}, not_lm{};
-		};
-
-        coordinate_type		m_min_z{ -2.0 };
-        coordinate_type		m_max_z{ 50.0 };
-        bool				m_lm_filter{ false };
-		
-		metadata			m_metadata{};
+		using coordinate_type		  = Z_class_filter::coordinate_type;
+
+		Z_class_filter		m_filter{};
 		pdal::Dimension::Id	m_height_id{};
 	};
 
-} // namespace pax
\ No newline at end of file
+} // namespace pax
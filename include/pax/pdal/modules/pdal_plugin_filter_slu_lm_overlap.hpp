@@ -0,0 +1,49 @@
+#pragma once
+
+#include <pax/pdal/modules/pdal_plugin_filter_remove_overlap.hpp>	// Remove_overlap::Angle_source
+#include <pax/pdal/utilities/z-class-filter.hpp>
+
+#include <pdal/Filter.hpp>
+
+
+namespace pax {
+
+	/// The same as filters.slu_lm followed by filters.remove_overlap, but in a single stage.
+	/** The scan angle raster is built in the same pass as the z and class filtering, 
+		so the point cloud is traversed one time less and no intermediate point view is created.	**/
+	class PDAL_DLL slu_lm_overlap : public pdal::Filter {
+	public:
+		slu_lm_overlap()												  = default;
+		slu_lm_overlap( const slu_lm_overlap & )						  = delete;
+		slu_lm_overlap( slu_lm_overlap &&)								  = delete;
+		slu_lm_overlap & operator=( const slu_lm_overlap & )			  = delete;
+		slu_lm_overlap & operator=( slu_lm_overlap && )					  = delete;
+
+		virtual ~slu_lm_overlap();
+
+		using pdal::Filter::Filter;
+		std::string getName() 											const override;
+
+	private:
+		using coordinate_type		  = Z_class_filter::coordinate_type;
+		using angle_type			  = Remove_overlap::angle_type;
+		using source_id_type		  = Remove_overlap::source_id_type;
+		using Angle_source			  = Remove_overlap::Angle_source;
+
+		void addArgs( pdal::ProgramArgs & args_ )						override;
+		void addDimensions( pdal::PointLayoutPtr layout_ )				override;
+		void prepared( pdal::PointTableRef table_ )						override;
+		void ready( pdal::PointTableRef table_ )						override;
+		pdal::PointViewSet run( pdal::PointViewPtr view_ )				override;
+		void done( pdal::PointTableRef )								override;
+
+		Z_class_filter		m_filter{};
+		coordinate_type		m_overlap_resolution{ 0.0 };
+		pdal::Dimension::Id	m_height_id{};
+		std::size_t			m_points_out{};
+		bool				m_active{ false };
+		bool				m_has_source_id{ false };
+		bool				m_has_scan_angle{ false };
+	};
+
+} // namespace pax
@@ -5,6 +5,8 @@
 #pragma once
 
 #include <type_traits>
+#include <array>
+#include <cstdint>
 
 
 namespace pax::asprs {
@@ -78,6 +80,15 @@ namespace pax::asprs {
 			default:								return false;
 		}
 	}
+
+	/// normal_lm_filter as a lookup table, indexed by the raw classification value. 
+	/** For branch free filtering of many points.										**/
+	inline constexpr auto normal_lm_lookup = [](){
+		std::array< std::uint8_t, 256 >		table{};
+		for( std::size_t c{}; c<table.size(); ++c )
+			table[ c ] = normal_lm_filter( Classification( c ) );
+		return table;
+	}();
 	
 	
 	/// Is the point 'synthetic'?
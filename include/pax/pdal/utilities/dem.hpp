@@ -0,0 +1,230 @@
+//	Copyright (c) 2014-2016, Peder Axensten, all rights reserved.
+//	Contact: peder ( at ) axensten.se
+
+
+#pragma once
+
+#include <pax/types/point-stuff/point.hpp>
+#include <pax/reporting/error_message.hpp>
+
+#include <gdal.h>
+
+#include <algorithm>	// std::fill, std::min, std::max
+#include <cassert>
+#include <cmath>		// std::isnan
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <memory>		// std::unique_ptr
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+
+namespace pax {
+
+	/// A rectangular part of a DEM raster, with the heights as float and no-data values as NaN.
+	/** The coordinates are continuous raster coordinates of pixel centres, so (3, 2) is
+		the centre of the pixel in column 3 and row 2 of the whole raster.							**/
+	class Dem_tile {
+		std::size_t						m_col0{}, m_row0{}, m_cols{}, m_rows{};
+		std::vector< float >			m_heights{};	// No-data as 0, so that the interpolation has no selects.
+		std::vector< float >			m_data{};		// 1 where there is data, 0 where there is not.
+
+	public:
+		Dem_tile()										  = default;
+
+		/// heights_ is row major, with cols_*rows_ elements. The first element is pixel ( col0_, row0_ ) of the raster.
+		Dem_tile(
+			const std::size_t			col0_,
+			const std::size_t			row0_,
+			const std::size_t			cols_,
+			const std::size_t			rows_,
+			std::vector< float >		heights_
+		) : m_col0{ col0_ }, m_row0{ row0_ }, m_cols{ cols_ }, m_rows{ rows_ }, m_heights{ std::move( heights_ ) } {
+			assert( m_heights.size() == m_cols * m_rows );
+			assert( m_cols && m_rows );
+			m_data.resize( m_heights.size() );
+			for( std::size_t i{}; i<m_heights.size(); ++i ) {
+				m_data[ i ]		  = !std::isnan( m_heights[ i ] );
+				m_heights[ i ]	  = m_data[ i ] ? m_heights[ i ] : 0.0f;
+			}
+		}
+
+		/// Bilinear interpolation at the raster coordinates ( col_, row_ ).
+		/** - Outside the tile, the values at the edge are used.
+			- No-data values are disregarded and the weights of the rest are rescaled.
+			- Returns NaN if all four neighbours are no-data (the weights add up to 0).
+			It has neither branches nor selects on the data, so that a loop over it may be vectorised. 
+			The indices are truncated after clamping, as std::floor keeps gcc from vectorising.			**/
+		double operator()( const double col_, const double row_ )	const noexcept	{
+			const double	u	  = col_ - m_col0;
+			const double	v	  = row_ - m_row0;
+			const int		cols  = int( m_cols ), rows = int( m_rows );
+			const int		c0	  = int( std::min( double( cols - 1 ), std::max( 0.0, u ) ) );	// NaN gives 0.
+			const int		r0	  = int( std::min( double( rows - 1 ), std::max( 0.0, v ) ) );
+			const int		c1	  = std::min( c0 + 1, cols - 1 );
+			const int		r1	  = std::min( r0 + 1, rows - 1 );
+			const double	fx	  = std::min( 1.0, std::max( 0.0, u - c0 ) );
+			const double	fy	  = std::min( 1.0, std::max( 0.0, v - r0 ) );
+
+			const int		i[ 4 ]= {	r0*cols + c0,					r0*cols + c1,
+										r1*cols + c0,					r1*cols + c1					};
+			const double	w[ 4 ]= {	( 1 - fx )*( 1 - fy ),			fx*( 1 - fy ),
+										( 1 - fx )*fy,					fx*fy							};
+			double			sum{}, weights{};
+			for( std::size_t k{}; k<4; ++k ) {
+				sum			 += w[ k ] * m_heights[ i[ k ] ];
+				weights		 += w[ k ] * m_data[ i[ k ] ];
+			}
+			return sum/weights;
+		}
+
+		/// Bilinear interpolation of a batch: result_[ i ] is ( *this )( col_[ i ], row_[ i ] ).
+		void operator()(
+			const std::span< const double >		col_,
+			const std::span< const double >		row_,
+			const std::span< double >			result_
+		) const noexcept {
+			assert( ( col_.size() == row_.size() ) && ( col_.size() == result_.size() ) );
+			for( std::size_t i{}; i<col_.size(); ++i )
+				result_[ i ]	  = ( *this )( col_[ i ], row_[ i ] );
+		}
+	};
+
+
+
+	/// Ground heights from a DEM raster file, read a tile at a time as needed.
+	/** Only the tiles that points fall into are read, each of them once. A point cloud tile typically covers
+		a handful of DEM tiles, so a national DEM is never sampled through GDAL point by point.
+		The DEM may not be rotated.																	**/
+	class Dem_cache {
+		struct Close_dataset {
+			void operator()( GDALDatasetH ds_ )	const noexcept	{	GDALClose( ds_ );	}
+		};
+
+		std::unique_ptr< void, Close_dataset >			m_dataset{};
+		GDALRasterBandH									m_band{};
+		double											m_affine[ 6 ]{};
+		std::size_t										m_cols{}, m_rows{};
+		std::unordered_map< std::size_t, Dem_tile >		m_tiles{};
+		static constexpr std::size_t					outside{ std::numeric_limits< std::size_t >::max() };	// Tile key.
+
+		std::size_t										m_last_key{ outside };
+		const Dem_tile								  * m_last{};	// Consecutive points are usually in the same tile.
+		std::vector< double >							m_col{}, m_row{};	// Scratch for batches.
+		std::vector< std::size_t >						m_key{};
+
+		/// Continuous raster coordinates, with pixel centres at integer values.
+		double col( const double x_ )					const noexcept	{	return ( x_ - m_affine[ 0 ] ) / m_affine[ 1 ] - 0.5;	}
+		double row( const double y_ )					const noexcept	{	return ( y_ - m_affine[ 3 ] ) / m_affine[ 5 ] - 0.5;	}
+
+		/// The key of the tile of the upper left of the four pixels used for the interpolation, or outside.
+		std::size_t key( const double col_, const double row_ )	const noexcept	{
+			const bool			inside = ( col_ >= -0.5 ) & ( row_ >= -0.5 ) & ( col_ <= m_cols - 0.5 ) & ( row_ <= m_rows - 0.5 );
+			// Truncated after clamping, as in Dem_tile. NaN gives 0.
+			const auto			c0 = std::size_t( std::min( double( m_cols - 1 ), std::max( 0.0, col_ ) ) );
+			const auto			r0 = std::size_t( std::min( double( m_rows - 1 ), std::max( 0.0, row_ ) ) );
+			return inside ? ( r0 / tile_side ) * tiles_per_row() + c0 / tile_side : outside;
+		}
+
+		std::size_t tiles_per_row()						const noexcept	{	return m_cols / tile_side + 1;	}
+
+		/// The tile with key_ (not outside), read if needed.
+		const Dem_tile & tile( const std::size_t key_ ) {
+			if( key_ != m_last_key ) {
+				auto			found = m_tiles.find( key_ );
+				if( found == m_tiles.end() )
+					found		  = m_tiles.emplace( key_, read_tile( key_ % tiles_per_row(), key_ / tiles_per_row() ) ).first;
+				m_last_key		  = key_;
+				m_last			  = &found->second;
+			}
+			return *m_last;
+		}
+
+		/// Read a tile, with one extra column and row so that interpolation never needs a neighbouring tile.
+		Dem_tile read_tile( const std::size_t tile_col_, const std::size_t tile_row_ )	const {
+			const std::size_t		col0 = tile_col_ * tile_side, row0 = tile_row_ * tile_side;
+			const std::size_t		cols = std::min( tile_side + 1, m_cols - col0 );
+			const std::size_t		rows = std::min( tile_side + 1, m_rows - row0 );
+			std::vector< float >	heights( cols * rows );
+			if( GDALRasterIO( m_band, GF_Read, int( col0 ), int( row0 ), int( cols ), int( rows ),
+				heights.data(), int( cols ), int( rows ), GDT_Float32, 0, 0 ) != CE_None
+			)	throw error_message( std::format( "Could not read DEM pixels ({}, {}) to ({}, {}): {}",
+					col0, row0, col0 + cols, row0 + rows, CPLGetLastErrorMsg() ) );
+
+			int						has_nodata{};
+			const double			nodata = GDALGetRasterNoDataValue( m_band, &has_nodata );
+			if( has_nodata ) for( auto & h : heights )
+				if( h == float( nodata ) )		h = std::numeric_limits< float >::quiet_NaN();
+			return Dem_tile{ col0, row0, cols, rows, std::move( heights ) };
+		}
+
+	public:
+		/// The tile side in pixels.
+		static constexpr std::size_t					tile_side{ 256 };
+
+		Dem_cache()										  = default;
+
+		/// Open band_ (starting at 1) of the raster file dem_.
+		Dem_cache( const std::filesystem::path & dem_, const int band_ = 1 ) {
+			GDALAllRegister();
+			m_dataset.reset( GDALOpen( dem_.c_str(), GA_ReadOnly ) );
+			if( !m_dataset )
+				throw error_message( std::format( "Could not open DEM file '{}': {}", dem_.native(), CPLGetLastErrorMsg() ) );
+			if( GDALGetGeoTransform( m_dataset.get(), m_affine ) != CE_None )
+				throw error_message( std::format( "The DEM file '{}' has no affine transformation.", dem_.native() ) );
+			if( ( m_affine[ 2 ] != 0 ) || ( m_affine[ 4 ] != 0 ) )
+				throw error_message( std::format( "The DEM file '{}' is rotated, that is not supported.", dem_.native() ) );
+			m_band		  = GDALGetRasterBand( m_dataset.get(), band_ );
+			if( !m_band )
+				throw error_message( std::format( "The DEM file '{}' has no band {}.", dem_.native(), band_ ) );
+			m_cols		  = GDALGetRasterXSize( m_dataset.get() );
+			m_rows		  = GDALGetRasterYSize( m_dataset.get() );
+		}
+
+		/// Is there an open DEM?
+		explicit operator bool()						const noexcept	{	return bool( m_dataset );	}
+
+		/// The number of tiles read so far.
+		std::size_t tiles_read()						const noexcept	{	return m_tiles.size();		}
+
+		/// The ground height at pt_. Returns NaN if pt_ is outside the DEM or there is no data.
+		double operator()( const Point2d & pt_ ) {
+			const double		c = col( x( pt_ ) ), r = row( y( pt_ ) );
+			const std::size_t	k = key( c, r );
+			return ( k == outside ) ? std::numeric_limits< double >::quiet_NaN() : tile( k )( c, r );
+		}
+
+		/// The ground heights of a batch of points: result_[ i ] is the ground height at ( x_[ i ], y_[ i ] ).
+		/** The same values as one point at a time, but in separate passes: the raster coordinates of all points, 
+			then their tiles, and then the interpolation of each run of consecutive points in the same tile.
+			The passes are simple loops without branches, that the compiler may vectorise.				**/
+		void operator()(
+			const std::span< const double >		x_,
+			const std::span< const double >		y_,
+			const std::span< double >			result_
+		) {
+			assert( ( x_.size() == y_.size() ) && ( x_.size() == result_.size() ) );
+			const std::size_t	n = x_.size();
+			m_col.resize( n );
+			m_row.resize( n );
+			m_key.resize( n );
+			for( std::size_t i{}; i<n; ++i )	m_col[ i ] = col( x_[ i ] );
+			for( std::size_t i{}; i<n; ++i )	m_row[ i ] = row( y_[ i ] );
+			for( std::size_t i{}; i<n; ++i )	m_key[ i ] = key( m_col[ i ], m_row[ i ] );
+
+			for( std::size_t first{}; first<n; ) {
+				const std::size_t	k = m_key[ first ];
+				std::size_t			last{ first + 1 };
+				while( ( last < n ) && ( m_key[ last ] == k ) )		++last;
+				const auto			res = result_.subspan( first, last - first );
+				if( k == outside )	std::fill( res.begin(), res.end(), std::numeric_limits< double >::quiet_NaN() );
+				else				tile( k )( std::span< const double >( m_col ).subspan( first, last - first ), 
+										std::span< const double >( m_row ).subspan( first, last - first ), res );
+				first			  = last;
+			}
+		}
+	};
+
+}	// namespace pax
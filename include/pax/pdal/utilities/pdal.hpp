@@ -6,6 +6,15 @@
 
 #include <pax/types/point-stuff/box.hpp>
 #include <pdal/PointView.hpp>			// PointViewPtr, PointId
+#include <pdal/PointTable.hpp>			// BasePointTable::metadata()
+#include <pdal/Metadata.hpp>			// MetadataNode
+#include <pdal/Stage.hpp>				// Stage::getInputs()
+
+#include <charconv>						// std::from_chars
+#include <cmath>						// std::round
+#include <mutex>
+#include <optional>
+#include <unordered_map>
 
 
 namespace pax {
@@ -37,11 +46,128 @@ namespace pax {
 	inline constexpr Box  < double, 2 > box( const BOX2D & b_ )	{	return { min( b_ ), max( b_ )		 };			}
 	inline constexpr Box  < double, 3 > box( const BOX3D & b_ )	{	return { min( b_ ), max( b_ )		 };			}
 
-	// Convert pdal PointView to Box.
-	inline constexpr Box< double, 2 > box( const PointView & vw_ )	{
+	/// Convert pdal PointView to Box, with a full scan over X and Y.
+	/** Within a pipeline, use box( stage, view ) to reuse the bounds that the pax stage before already has.	**/
+	inline Box< double, 2 > box( const PointView & vw_ )	{
 		BOX2D					pdal_box{};
 		vw_.calculateBounds( pdal_box );
 		return box( pdal_box );
 	}
 
+
+	/// The bounds of the views that pax stages output, so that the pax stage directly after need not scan for them.
+	/** A stage remembers the bounds of a view it outputs if it knows them anyway: it produced the view (and 
+		found the bounds while appending the points) or it did not move any point (e.g. raster_metrics). 
+		Only the bounds of the direct inputs of a stage are used. Any other stage in between might change X or Y 
+		in place (e.g. filters.transformation or filters.reprojection) and still output the same view. 
+		- Each stage has the bounds of its latest view only, identified by the view id and size.
+		- Nothing is put in the table metadata, so nothing shows up in the output metadata. 
+		- The las header bounds are not used for views: a view need not hold the points as the header has them.	**/
+	class View_bounds {
+		struct Entry {
+			int								id;
+			pdal::point_count_t				size;
+			Box< double, 2 >				box;
+		};
+
+		static std::mutex & mutex() noexcept {
+			static std::mutex				m{};
+			return m;
+		}
+		static std::unordered_map< const pdal::Stage *, Entry > & entries() noexcept {
+			static std::unordered_map< const pdal::Stage *, Entry >	e{};
+			return e;
+		}
+
+	public:
+		/// Remember box_ as the bounds of the view vw_, that stage_ outputs.
+		static void remember( const pdal::Stage & stage_, const PointView & vw_, const Box< double, 2 > & box_ ) {
+			const std::lock_guard			lock( mutex() );
+			entries().insert_or_assign( &stage_, Entry{ vw_.id(), vw_.size(), box_ } );
+		}
+
+		/// Forget what stage_ remembers, e.g. as it is destroyed.
+		static void forget( const pdal::Stage & stage_ ) {
+			const std::lock_guard			lock( mutex() );
+			entries().erase( &stage_ );
+		}
+
+		/// The bounds of vw_ as output by stage_, if it remembers them.
+		static std::optional< Box< double, 2 > > find( const pdal::Stage & stage_, const PointView & vw_ ) {
+			const std::lock_guard			lock( mutex() );
+			const auto						found = entries().find( &stage_ );
+			if( ( found == entries().end() ) || ( found->second.id != vw_.id() ) || ( found->second.size != vw_.size() ) )
+				return std::nullopt;
+			return found->second.box;
+		}
+	};
+
+	/// The bounds of vw_, an input view of stage_: as remembered by a direct input stage, or else with a full scan.
+	inline Box< double, 2 > box( pdal::Stage & stage_, const PointView & vw_ )	{
+		for( const pdal::Stage * input : stage_.getInputs() )
+			if( const auto found = View_bounds::find( *input, vw_ ) )	return *found;
+		return box( vw_ );
+	}
+
+	/// The bounds of the points appended to a view, found while appending them.
+	class Bounds_of_appended {
+		BOX2D								m_box{};
+
+	public:
+		/// Call this for each point appended.
+		void add( const double x_, const double y_ )				noexcept	{	m_box.grow( x_, y_ );	}
+		void add( const Point< double, 2 > & pt_ )				noexcept	{	m_box.grow( pt_[ 0 ], pt_[ 1 ] );	}
+
+		/// Remember the bounds for the view vw_ that stage_ outputs. An empty view has no bounds to remember.
+		void remember( const pdal::Stage & stage_, const PointView & vw_ )	const	{
+			if( !m_box.empty() )			View_bounds::remember( stage_, vw_, box( m_box ) );
+		}
+	};
+
+
+
+	namespace detail {
+
+		inline std::optional< double > metadata_value( const pdal::MetadataNode & node_, const std::string & name_ ) {
+			const pdal::MetadataNode	item = node_.findChild( name_ );
+			if( !item.valid() )			return std::nullopt;
+			const std::string			text = item.value();
+			double						result{};
+			const auto [ ptr, ec ]	  = std::from_chars( text.data(), text.data() + text.size(), result );
+			if( ( ec != std::errc{} ) || ( ptr != text.data() + text.size() ) )
+				return std::nullopt;
+			return result;
+		}
+
+		/// Snap a header coordinate onto the lattice of coordinates that the las reader produces.
+		/** The header values pass through text in the metadata, so they might be an ulp off the actual points.	**/
+		inline double snap( const double v_, const double scale_, const double offset_ ) noexcept {
+			return ( scale_ > 0 ) ? std::round( ( v_ - offset_ )/scale_ ) * scale_ + offset_ : v_;
+		}
+
+	}	// namespace detail
+
+
+	/// The bounds of the las file being read, from its header. Use it when there is no view, as when streaming.
+	/** The bounds contain all points of the file, so they also contain any subset of them.	**/
+	inline std::optional< Box< double, 2 > > header_box( pdal::BasePointTable & table_ ) {
+		const pdal::MetadataNode	las = table_.metadata().findChild( "readers.las" );
+		if( !las.valid() )			return std::nullopt;
+
+		using detail::metadata_value, detail::snap;
+		const auto minx = metadata_value( las, "minx" ), miny = metadata_value( las, "miny" );
+		const auto maxx = metadata_value( las, "maxx" ), maxy = metadata_value( las, "maxy" );
+		if( !minx || !miny || !maxx || !maxy )
+			return std::nullopt;
+
+		const double scx = metadata_value( las, "scale_x"  ).value_or( 0 );
+		const double scy = metadata_value( las, "scale_y"  ).value_or( 0 );
+		const double ofx = metadata_value( las, "offset_x" ).value_or( 0 );
+		const double ofy = metadata_value( las, "offset_y" ).value_or( 0 );
+		return Box< double, 2 >{
+			{ snap( *minx, scx, ofx ), snap( *miny, scy, ofy ) }, 
+			{ snap( *maxx, scx, ofx ), snap( *maxy, scy, ofy ) }
+		};
+	}
+
 }	// namespace pax
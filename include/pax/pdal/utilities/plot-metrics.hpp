@@ -0,0 +1,214 @@
+//	Copyright (c) 2014-2016, Peder Axensten, all rights reserved.
+//	Contact: peder ( at ) axensten.se
+
+
+#pragma once
+
+#include <pax/tables/text-table.hpp>
+#include <pax/tables/concat-tables.hpp>
+#include <pax/textual/json.hpp>
+#include <pax/pdal/metrics-infrastructure/metric-kernel.hpp>
+
+#include <algorithm>	// std::find_if
+#include <charconv>		// std::to_chars
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+
+namespace pax {
+
+	/// A row of a plots table and the aggregated values of its plot.
+	/// With several radii (see save_metric_rows), the aggregators of the radii follow each other.
+	using Plot_row	  = std::pair< std::size_t, metrics::Point_aggregator * >;
+
+	/// The columns with the values of a plot that is partially within a tile. They are the last columns.
+	static constexpr std::string_view	partial_z_col		= "partial_z";
+	static constexpr std::string_view	partial_z_1ret_col	= "partial_z_1ret";
+
+
+	namespace detail {
+		// Append the shortest text that reads back to the same value_.
+		inline void append_value( std::string & line_, const metrics::metrics_value_type value_ ) {
+			char						buffer[ 64 ];
+			const auto [ ptr, ec ]	  = std::to_chars( buffer, buffer + sizeof( buffer ), value_ );
+			line_.append( buffer, ptr );
+		}
+
+		// Append the header or row r_ of table_, only the first cols_ columns.
+		inline void append_row(
+			std::string				  & line_,
+			const Text_table< char >  & table_,
+			const std::size_t			r_,		// -1 means the header.
+			const std::size_t			cols_
+		) {
+			for( std::size_t c{}; c<cols_; ++c )	{
+				if( c )					line_ += table_.col_mark();
+				line_				   += ( r_ == std::size_t( -1 ) ) ? table_.header()[ c ] : table_[ r_, c ];
+			}
+		}
+	}
+
+
+	/// Save rows_ of table_, with metrics_ calculated from their aggregators, to a csv file at dest_.
+	/** - Only the first cols_ columns of table_ are saved.
+		- A metric with the same name as an existing column replaces it, the others are added as new columns.
+		- With suffixes_, each row has one aggregator per suffix (e.g. one per plot radius) and 
+		  each metric gets a column per suffix, named by the metric followed by the suffix. 
+		- The file is written directly: the original cells are copied and the metric values are formatted in place.
+		- The metrics are calculated by a metrics::Metric_kernel, so metrics with the same filter share work
+		  and preconfigured metric sets use a kernel specialised for them.
+		- Calculating the metrics mutates the aggregators (the values are sorted in place).							**/
+	inline void save_metric_rows(
+		const Text_table< char >						  & table_,
+		const std::span< const Plot_row >					rows_,
+		const std::size_t									cols_,
+		const dest_path									  & dest_,
+		const std::span< const metrics::Function_filter >	metrics_,
+		const std::span< const std::string >				suffixes_ = {}
+	) {
+		// Metric column j is metric j % metrics_.size() of aggregator j / metrics_.size().
+		const std::size_t					aggregators = std::max( std::size_t( 1 ), suffixes_.size() );
+		std::vector< std::string >			metric_names{};
+		metric_names.reserve( aggregators*metrics_.size() );
+		for( std::size_t k{}; k<aggregators; ++k )
+			for( const auto name : metrics_ )
+				metric_names.push_back( suffixes_.empty() ? to_string( name ) : to_string( name ) + suffixes_[ k ] );
+
+		std::vector< std::size_t >			replaces( cols_, std::size_t( -1 ) );	// Column c is replaced by metric replaces[ c ].
+		std::vector< std::size_t >			appended{};				// Metrics in new columns.
+		for( std::size_t m{}; m<metric_names.size(); ++m ) {
+			const std::size_t				c = table_.header().index( metric_names[ m ] );
+			if( c < cols_ )					replaces[ c ] = m;
+			else if( std::find_if( appended.begin(), appended.end(),
+				[ & ]( std::size_t a ){ return metric_names[ a ] == metric_names[ m ]; } ) == appended.end()
+			)								appended.push_back( m );
+		}
+
+		const char							mark = table_.col_mark();
+		Safe_ofstream< char >				out{ dest_ };
+		std::string							line{};
+		detail::append_row( line, table_, std::size_t( -1 ), cols_ );
+		for( const std::size_t m : appended )	( line += mark ) += metric_names[ m ];
+		line							   += '\n';
+		out.write( line.data(), line.size() );
+
+		const metrics::Metric_kernel		kernel{ metrics_ };
+		std::vector< metrics::metrics_value_type >	values( metric_names.size() );
+		for( const auto [ r, aggregator ] : rows_ ) {
+			for( std::size_t k{}; k<aggregators; ++k )
+				kernel.calculate( aggregator[ k ], std::span( values ).subspan( k*metrics_.size(), metrics_.size() ) );
+
+			line.clear();
+			for( std::size_t c{}; c<cols_; ++c )	{
+				if( c )						line += mark;
+				if( replaces[ c ] < metric_names.size() )	detail::append_value( line, values[ replaces[ c ] ] );
+				else						line += table_[ r, c ];
+			}
+			for( const std::size_t m : appended ) {
+				line					   += mark;
+				detail::append_value( line, values[ m ] );
+			}
+			line						   += '\n';
+			out.write( line.data(), line.size() );
+		}
+		out.close();
+	}
+
+
+	/// Save rows_ of table_, with the values of their aggregators, to a csv file at dest_.
+	/** This is for plots that are only partially within a point cloud tile.
+		The values of all tiles are later merged by merge_partial_plots.
+		- The values are saved space separated in two added columns: partial_z_col and partial_z_1ret_col.
+		- The values are saved as the shortest text that reads back to the same values. 
+		- It is the raw values as text (the first returns twice), so the file can get large.					**/
+	inline void save_partial_rows(
+		const Text_table< char >						  & table_,
+		const std::span< const Plot_row >					rows_,
+		const dest_path									  & dest_
+	) {
+		const char							mark = table_.col_mark();
+		Safe_ofstream< char >				out{ dest_ };
+		std::string							line{};
+		detail::append_row( line, table_, std::size_t( -1 ), table_.cols() );
+		( ( ( line += mark ) += partial_z_col ) += mark ) += partial_z_1ret_col;
+		line							   += '\n';
+		out.write( line.data(), line.size() );
+
+		const auto	append_values = [ & ]( const std::span< const metrics::metrics_value_type > values_ ) {
+			line						   += mark;
+			for( std::size_t i{}; i<values_.size(); ++i ) {
+				if( i )						line += ' ';
+				detail::append_value( line, values_[ i ] );
+			}
+		};
+		for( const auto [ r, aggregator ] : rows_ ) {
+			line.clear();
+			detail::append_row( line, table_, r, table_.cols() );
+			append_values( aggregator->ordered_values( false ) );
+			append_values( aggregator->ordered_values( true ) );
+			line						   += '\n';
+			out.write( line.data(), line.size() );
+		}
+		out.close();
+	}
+
+
+	/// Merge the partial plot files (as saved by save_partial_rows) in the directory source_ and save the metrics to dest_.
+	/** - The partial rows are merged by the plot id, in column id_col_.
+		- The other columns are taken from the first partial row of each plot.
+		- The resulting file has the same format as the plot metrics files. 									**/
+	inline Json_value merge_partial_plots(
+		const dir_path									  & source_,
+		const dest_path									  & dest_,
+		const std::span< const metrics::Function_filter >	metrics_,
+		const std::string_view								id_col_
+	) {
+		Append_tables						concat{};
+		concat.process( source_ );
+		if( concat.str().empty() )
+			throw error_message( std::format( "No partial plot files found in '{}'.", to_string( source_ ) ) );
+
+		// The values contain many '.', so the column delimiter is found from the header row only.
+		std::string							text{ concat.str() };
+		const char							mark = String_meta( until( std::string_view( text ), linebreak{} ) ).col_delimiter();
+		const Text_table< char >			table{ std::move( text ), mark };
+		const std::size_t					cols = table.cols();
+		const std::size_t					id_col = table.header().index( id_col_ );
+		if( id_col >= cols )
+			throw error_message( std::format( "In the partial plot files, there is no column \"{}\".", id_col_ ) );
+		if( ( cols < 2 ) || ( table.header()[ cols - 2 ] != partial_z_col ) || ( table.header()[ cols - 1 ] != partial_z_1ret_col ) )
+			throw error_message( std::format( "The last columns of the partial plot files should be \"{}\" and \"{}\".",
+				partial_z_col, partial_z_1ret_col ) );
+
+		// Merge the values by plot id.
+		std::unordered_map< std::string_view, std::size_t >	plot_of_id{};
+		std::vector< metrics::Point_aggregator >			aggregators{};
+		std::vector< Plot_row >								rows{};
+		aggregators.reserve( table.rows() );		// The pointers in rows must stay valid.
+		std::vector< metrics::metrics_value_type >			all{}, firsts{};
+		const auto	parse = [ & ]( const std::string_view cell_, std::vector< metrics::metrics_value_type > & values_ ) {
+			values_.clear();
+			for( const auto cell : String_view_splitter( cell_, ' ' ) )
+				if( const auto value = make_view( cell ); !value.empty() )
+					values_.push_back( from_string< metrics::metrics_value_type >( value ) );
+		};
+		for( std::size_t r{}; r<table.rows(); ++r ) {
+			const auto [ found, is_new ]  = plot_of_id.try_emplace( table[ r, id_col ], aggregators.size() );
+			if( is_new ) {
+				aggregators.emplace_back();
+				rows.emplace_back( r, &aggregators.back() );
+			}
+			parse( table[ r, cols - 2 ], all );
+			parse( table[ r, cols - 1 ], firsts );
+			aggregators[ found->second ].push_back( std::span( all ), std::span( firsts ) );
+		}
+
+		save_metric_rows( table, rows, cols - 2, dest_, metrics_ );
+		return Json_value{
+			{	"partial-rows",		table.rows()		},
+			{	"plots",			rows.size()			}
+		};
+	}
+
+}	// namespace pax
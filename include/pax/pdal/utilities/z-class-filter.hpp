@@ -0,0 +1,132 @@
+//	Copyright (c) 2014-2016, Peder Axensten, all rights reserved.
+//	Contact: peder ( at ) axensten.se
+
+
+#pragma once
+
+#include <pax/pdal/utilities/classification.hpp>	// asprs::normal_lm_lookup
+
+#include <pdal/Metadata.hpp>						// MetadataNode
+
+#include <bit>										// std::popcount
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <span>
+
+
+namespace pax {
+
+	/// Filtering according to z-values and point type, as used by filters.slu_lm and filters.slu_lm_overlap. 
+	/** It also counts the reasons for excluding points. 
+		- Set min_z, max_z, and lm_filter (typically as pdal arguments) and call ready() before any filtering. 
+		- Kept points with a negative height should have it set to zero, see clamped().				**/
+	class Z_class_filter {
+	public:
+		using coordinate_type		  = double;
+
+		/// Blocks of points are filtered with one bit per point in a std::uint64_t.
+		static constexpr std::size_t	block_size{ 64 };
+
+		struct metadata {
+			std::size_t 	points_in{}, points_out{};
+			std::size_t 	z_negative{}, z_small{}, z_large{}, z_missing{}, not_lm{};
+		};
+
+		coordinate_type					min_z{ -2.0 };
+		coordinate_type					max_z{ 50.0 };
+		bool							lm_filter{ false };
+
+		/// Call this when the argument values are set.
+		void ready()										noexcept	{
+			// No z-value filtering?
+			if( max_z < min_z ) {
+				min_z = std::numeric_limits< coordinate_type >::lowest();
+				max_z = std::numeric_limits< coordinate_type >::max();
+			}
+		}
+
+		/// Negative heights are set to zero.
+		static constexpr coordinate_type clamped( const coordinate_type z_ )	noexcept	{
+			return ( z_ < 0 ) ? 0.0 : z_;
+		}
+
+		/// Should the point be kept? 
+		bool keep( 
+			const coordinate_type		z_, 
+			const std::uint8_t			class_ 
+		) noexcept {
+			++m_metadata.points_in;
+			const bool	is_lm	  = asprs::normal_lm_lookup[ class_ ];
+			if( ( z_ >= min_z ) && ( z_ <= max_z ) && ( !lm_filter || is_lm ) ) {
+				++m_metadata.points_out;
+				( z_ < 0 )		? ++m_metadata.z_negative : 0;
+				return true;
+			}
+			// Exclude the point, but count the reason for exclusion.
+			( z_ < min_z )	? ++m_metadata.z_small : 0;
+			( z_ > max_z )	? ++m_metadata.z_large : 0;
+			( z_ != z_ )	? ++m_metadata.z_missing : 0;		// NaN, e.g. no ground height from filters.slu_hag.
+			!is_lm			? ++m_metadata.not_lm : 0;
+			return false;
+		}
+
+		/// What points in a block should be kept? Returns a bit mask, bit i is set if point i is to be kept.
+		/** The counting is the same as for keep( z, class ).		**/
+		std::uint64_t keep(
+			const std::span< const coordinate_type >	z_, 
+			const std::span< const std::uint8_t >		class_
+		) noexcept {
+			assert( ( z_.size() == class_.size() ) && ( z_.size() <= block_size ) );
+
+			// Branch free, so that the compiler may vectorize it. One bit per point.
+			std::uint64_t		keep{}, small{}, large{}, missing{}, not_lm{}, negative{};
+			const std::uint64_t	no_lm_filter = !lm_filter;
+			for( std::size_t i{}; i<z_.size(); ++i ) {
+				const std::uint64_t	is_lm	  = asprs::normal_lm_lookup[ class_[ i ] ];
+				const std::uint64_t	ok_z	  = ( z_[ i ] >= min_z ) & ( z_[ i ] <= max_z );
+				keep					 |= ( ok_z & ( is_lm | no_lm_filter ) )	<< i;
+				small					 |= std::uint64_t( z_[ i ] < min_z )	<< i;
+				large					 |= std::uint64_t( z_[ i ] > max_z )	<< i;
+				missing					 |= std::uint64_t( z_[ i ] != z_[ i ] )	<< i;
+				not_lm					 |= ( is_lm ^ 1u )						<< i;
+				negative				 |= std::uint64_t( z_[ i ] < 0 )		<< i;
+			}
+
+			m_metadata.points_in		 += z_.size();
+			m_metadata.points_out		 += std::popcount( keep );
+			m_metadata.z_negative		 += std::popcount( keep & negative );
+			m_metadata.z_small			 += std::popcount( ~keep & small );
+			m_metadata.z_large			 += std::popcount( ~keep & large );
+			m_metadata.z_missing		 += std::popcount( missing );
+			m_metadata.not_lm			 += std::popcount( ~keep & not_lm );
+			return keep;
+		}
+
+		/// Access the counters.
+		const metadata & counters()							const noexcept	{	return m_metadata;	}
+
+		/// Add the arguments and counters to the metadata of a stage.
+		void add_metadata( pdal::MetadataNode & meta_ )		const			{
+			// Metadata: arguments:
+			pdal::MetadataNode					arguments( "arguments" );
+			arguments.add( "min_z",				min_z );
+			arguments.add( "max_z",				max_z );
+			arguments.add( "lm_filter",			lm_filter );
+			meta_.add( arguments );
+		
+			// Metadata: filtering:
+			pdal::MetadataNode					filtering( "filtering" );
+			filtering.add( "not-lm",			m_metadata.not_lm );
+			filtering.add( "z-to-large",		m_metadata.z_large );
+			filtering.add( "z-made-zero",		m_metadata.z_negative );
+			filtering.add( "z-to-small",		m_metadata.z_small );
+			filtering.add( "z-missing",			m_metadata.z_missing );
+			meta_.add( filtering );
+		}
+
+	private:
+		metadata						m_metadata{};
+	};
+
+}	// namespace pax
@@ -0,0 +1,125 @@
+//	Copyright (c) 2014-2016, Peder Axensten, all rights reserved.
+//	Contact: peder ( at ) axensten.se
+
+
+#pragma once
+
+#include <sys/mman.h>	// mmap, munmap, madvise
+
+#include <algorithm>	// std::max
+#include <array>
+#include <bit>			// std::bit_width
+#include <cstddef>		// std::byte, std::max_align_t
+#include <cstdint>		// std::uintptr_t
+#include <memory_resource>
+#include <new>			// std::bad_alloc
+#include <utility>		// std::exchange, std::pair
+#include <vector>
+
+
+namespace pax {
+
+	/// A memory resource that hands out memory from large pages, and frees it all at once when it is destroyed.
+	/** Meant for very many small containers that grow by doubling, e.g. one Point_aggregator per raster pixel:
+		- Memory is mapped in pages of page_size bytes (or larger, for larger allocations) and handed out in order.
+		- Sizes are rounded up to a power of two (at least 16 bytes), as the containers grow by doubling anyway.
+		- A deallocated block is kept for the next allocation of the same size, nothing is returned to the system
+		  until the resource is released or destroyed. So there is no fragmentation and the peak memory is predictable.
+		- With huge_pages, the system is advised to use huge pages (Linux only), so there are fewer TLB misses.
+		- It is not thread safe: use one per thread.												**/
+	class Arena_resource : public std::pmr::memory_resource {
+		static constexpr std::size_t		min_class{ 4 };				// Blocks of at least 16 bytes.
+		static constexpr std::size_t		alignment{ alignof( std::max_align_t ) };
+
+		struct Free_block {
+			Free_block					  * next;
+		};
+
+		std::size_t							m_page_size;
+		bool								m_huge_pages;
+		std::vector< std::pair< std::byte *, std::size_t > >	m_pages{};
+		std::byte						  * m_next{};					// The unused part of the last page.
+		std::byte						  * m_end{};
+		std::array< Free_block *, 64 >		m_free{};					// Deallocated blocks, by size class.
+		std::size_t							m_used{};
+
+		static constexpr std::size_t size_class( const std::size_t bytes_ )	noexcept	{
+			return std::max( min_class, std::size_t( std::bit_width( std::max( bytes_, std::size_t( 1 ) ) - 1 ) ) );
+		}
+
+		void new_page( const std::size_t bytes_ ) {
+			const std::size_t				size = std::max( m_page_size, bytes_ );
+			void						  * ptr = ::mmap( nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+			if( ptr == MAP_FAILED )			throw std::bad_alloc{};
+#			if defined( MADV_HUGEPAGE )
+				if( m_huge_pages )			::madvise( ptr, size, MADV_HUGEPAGE );
+#			endif
+			m_pages.emplace_back( static_cast< std::byte * >( ptr ), size );
+			m_next						  = m_pages.back().first;
+			m_end						  = m_next + size;
+		}
+
+		void * do_allocate( const std::size_t bytes_, const std::size_t alignment_ ) override {
+			const std::size_t				c = size_class( bytes_ );
+			const std::size_t				size = std::size_t( 1 ) << c;
+			m_used						 += size;
+			if( ( alignment_ <= alignment ) && m_free[ c ] )
+				return std::exchange( m_free[ c ], m_free[ c ]->next );
+
+			const std::size_t				align = std::max( alignment_, alignment );
+			const auto	padding = [ & ]{ return -reinterpret_cast< std::uintptr_t >( m_next ) & ( align - 1 ); };
+			if( !m_next || ( std::size_t( m_end - m_next ) < padding() + size ) )
+				new_page( size + align );
+			std::byte					  * ptr = m_next + padding();
+			m_next						  = ptr + size;
+			return ptr;
+		}
+
+		void do_deallocate( void * ptr_, const std::size_t bytes_, const std::size_t alignment_ ) override {
+			const std::size_t				c = size_class( bytes_ );
+			m_used						 -= std::size_t( 1 ) << c;
+			if( alignment_ <= alignment )	m_free[ c ] = ::new( ptr_ ) Free_block{ m_free[ c ] };
+		}
+
+		bool do_is_equal( const std::pmr::memory_resource & other_ )	const noexcept override	{
+			return this == &other_;
+		}
+
+	public:
+		/// The default page size, 64 MiB.
+		static constexpr std::size_t		default_page_size{ std::size_t( 64 ) << 20 };
+
+		explicit Arena_resource( const std::size_t page_size_ = default_page_size, const bool huge_pages_ = false ) noexcept
+			: m_page_size{ std::max( page_size_, std::size_t( 4096 ) ) }, m_huge_pages{ huge_pages_ } {}
+
+		Arena_resource( const Arena_resource & )				  = delete;
+		Arena_resource & operator=( const Arena_resource & )	  = delete;
+
+		/// All memory is freed, at once. Any container still using it must not be used afterwards.
+		~Arena_resource()											{	release();	}
+
+		/// Return all pages to the system, at once. Any container still using them must not be used afterwards.
+		/// The resource may be used again, it then maps new pages.
+		void release()										noexcept	{
+			for( const auto & [ ptr, size ] : m_pages )	::munmap( ptr, size );
+			m_pages.clear();
+			m_next						  = m_end = nullptr;
+			m_free.fill( nullptr );
+			m_used						  = 0;
+		}
+
+		/// The number of bytes mapped from the system.
+		std::size_t reserved()								const noexcept	{
+			std::size_t						bytes{};
+			for( const auto & page : m_pages )	bytes += page.second;
+			return bytes;
+		}
+
+		/// The number of bytes currently allocated (with the sizes rounded up to a power of two).
+		std::size_t used()									const noexcept	{	return m_used;				}
+
+		/// The number of pages mapped from the system.
+		std::size_t pages()									const noexcept	{	return m_pages.size();		}
+	};
+
+}	// namespace pax
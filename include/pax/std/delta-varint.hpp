@@ -0,0 +1,113 @@
+//	Copyright (c) 2014-2016, Peder Axensten, all rights reserved.
+//	Contact: peder ( at ) axensten.se
+
+
+#pragma once
+
+#include <cassert>
+#include <concepts>		// std::unsigned_integral
+#include <cstdint>
+#include <iterator>		// std::forward_iterator_tag
+#include <vector>
+
+
+namespace pax {
+
+	/// A compact container of non-decreasing unsigned integers, e.g. the ids of points in the order they were read.
+	/** Each value is stored as the difference to the previous value, in a variable number of bytes (7 bits per byte).
+		Ids of points in a plot are typically close to each other, so most of them need only a byte or two.
+		- The values can only be accessed in order, by iteration.
+		- Pushing a value smaller than the previous one is not allowed.												**/
+	template< std::unsigned_integral T >
+	class Delta_varint_vector {
+		std::vector< std::uint8_t >			m_bytes{};
+		std::size_t							m_size{};
+		T									m_last{};
+
+	public:
+		using value_type				  = T;
+
+		/// Iterates the values in order. Each value is decoded as the iterator gets to it.
+		class const_iterator {
+			const std::uint8_t			  * m_ptr{};		// The encoding of the current value.
+			const std::uint8_t			  * m_next{};		// The encoding of the next value.
+			const std::uint8_t			  * m_end{};
+			T								m_value{};
+
+			constexpr void decode()								  noexcept	{
+				if( m_ptr != m_end ) {
+					T						delta{};
+					unsigned				shift{};
+					m_next				  = m_ptr;
+					do {
+						delta			 |= T( *m_next & 0x7f ) << shift;
+						shift			 += 7;
+					} while( *m_next++ & 0x80 );
+					m_value				 += delta;
+				}
+			}
+
+		public:
+			using iterator_category		  = std::forward_iterator_tag;
+			using value_type			  = T;
+			using difference_type		  = std::ptrdiff_t;
+			using pointer				  = const T *;
+			using reference				  = T;
+
+			constexpr const_iterator()							  noexcept	= default;
+			constexpr const_iterator( const std::uint8_t * ptr_, const std::uint8_t * end_ ) noexcept
+				: m_ptr{ ptr_ }, m_end{ end_ }	{	decode();	}
+
+			constexpr T operator*()								const noexcept	{	return m_value;	}
+
+			constexpr const_iterator & operator++()				  noexcept	{
+				m_ptr					  = m_next;
+				decode();
+				return *this;
+			}
+			constexpr const_iterator operator++( int )			  noexcept	{
+				const_iterator				result{ *this };
+				++*this;
+				return result;
+			}
+
+			constexpr bool operator==( const const_iterator & other_ )	const noexcept	{	return m_ptr == other_.m_ptr;	}
+		};
+
+		constexpr Delta_varint_vector()								  = default;
+
+		/// Add value_ at the end. It may not be smaller than the previous value.
+		constexpr void push_back( const T value_ ) {
+			assert( ( m_size == 0 ) || ( value_ >= m_last ) );
+			T								delta = value_ - m_last;
+			while( delta >= 0x80 ) {
+				m_bytes.push_back( std::uint8_t( delta | 0x80 ) );
+				delta					>>= 7;
+			}
+			m_bytes.push_back( std::uint8_t( delta ) );
+			m_last						  = value_;
+			++m_size;
+		}
+
+		/// The number of values.
+		constexpr std::size_t size()							const noexcept	{	return m_size;				}
+		constexpr bool empty()									const noexcept	{	return m_size == 0;			}
+
+		/// The number of bytes used for the values.
+		constexpr std::size_t bytes()							const noexcept	{	return m_bytes.size();		}
+
+		constexpr void clear()									  noexcept	{
+			m_bytes.clear();
+			m_size						  = 0;
+			m_last						  = 0;
+		}
+
+		constexpr const_iterator begin()						const noexcept	{
+			return { m_bytes.data(), m_bytes.data() + m_bytes.size() };
+		}
+		constexpr const_iterator end()							const noexcept	{
+			return { m_bytes.data() + m_bytes.size(), m_bytes.data() + m_bytes.size() };
+		}
+	};
+
+}	// namespace pax
@@ -0,0 +1,205 @@
+//	Copyright (c) 2014-2016, Peder Axensten, all rights reserved.
+//	Contact: peder ( at ) axensten.se
+
+
+#pragma once
+
+#include "mapped-file.hpp"
+
+#include <algorithm>	// std::sort, std::lower_bound, std::adjacent_find
+#include <array>
+#include <cstdint>
+#include <cstring>		// std::memcmp, std::memcpy
+#include <string_view>
+#include <vector>
+
+
+namespace pax {
+
+	/// A single file holding many named members (e.g. point cloud files), meant to be memory mapped.
+	/** Thousands of small files are expensive on shared file systems, a single archive is not.
+		The members are stored as they are, one after the other, followed by an index sorted by name.
+		- Member names must be unique.
+		- The archive is in the native byte order, it is not meant to be moved between machines.
+
+		The file layout is:
+		- Head: magic and version (16 bytes).
+		- The members, one after the other, each aligned to 8 bytes.
+		- File_archive::Entry[ members ], sorted by name.
+		- The names, one after the other.
+		- File_archive::Trailer.																	**/
+	class File_archive {
+	public:
+		static constexpr char				magic[ 8 ]{ 'P', 'A', 'X', 'A', 'R', 'C', 'H', 'V' };
+		static constexpr std::uint32_t		version{ 1 };
+
+		struct Head {
+			char							magic[ 8 ];
+			std::uint32_t					version;
+			char							padding[ 4 ];
+		};
+
+		struct Entry {
+			std::uint64_t					offset, size;			// The member bytes.
+			std::uint64_t					name, name_size;		// The name, as offset in the names.
+		};
+
+		struct Trailer {
+			std::uint64_t					index;					// Offset of the first Entry.
+			std::uint64_t					members;
+			std::uint64_t					names_size;
+			char							magic[ 8 ];
+		};
+
+		/// Creates an archive: call append for each member, then close.
+		class Writer {
+			Safe_ofstream< char >			m_out;
+			std::vector< Entry >			m_entries{};
+			std::string						m_names{};
+			std::uint64_t					m_offset{};
+
+			void write( const void * data_, const std::size_t size_ ) {
+				m_out.write( static_cast< const char * >( data_ ), size_ );
+				m_offset				 += size_;
+			}
+
+			void align() {
+				static constexpr char		zeros[ 8 ]{};
+				write( zeros, ( 8 - m_offset % 8 ) % 8 );
+			}
+
+		public:
+			/// The archive is only saved as dest_ when closed.
+			explicit Writer( const dest_path & dest_ ) : m_out{ dest_, std::ios::out | std::ios::binary | std::ios::trunc } {
+				Head						head{};
+				std::memcpy( head.magic, magic, sizeof( magic ) );
+				head.version			  = version;
+				write( &head, sizeof( Head ) );
+			}
+
+			/// Append a member with the name name_ and the contents bytes_.
+			void append( const std::string_view name_, const std::span< const std::byte > bytes_ ) {
+				m_entries.push_back( { m_offset, bytes_.size(), m_names.size(), name_.size() } );
+				m_names					 += name_;
+				write( bytes_.data(), bytes_.size() );
+				align();
+			}
+
+			/// Append the contents of the file path_ as the member name_.
+			void append_file( const std::string_view name_, const file_path & path_ ) {
+				const Mapped_file			file{ path_ };
+				append( name_, file.bytes() );
+			}
+
+			/// The number of members so far.
+			std::size_t size()								const noexcept	{	return m_entries.size();	}
+
+			/// Write the index and save the archive. Throws if a name is used more than once.
+			void close() {
+				const auto	name = [ this ]( const Entry & e_ ){ return std::string_view( m_names ).substr( e_.name, e_.name_size ); };
+				std::sort( m_entries.begin(), m_entries.end(),
+					[ & ]( const Entry & a_, const Entry & b_ ){ return name( a_ ) < name( b_ ); } );
+				const auto					twin = std::adjacent_find( m_entries.begin(), m_entries.end(),
+					[ & ]( const Entry & a_, const Entry & b_ ){ return name( a_ ) == name( b_ ); } );
+				if( twin != m_entries.end() )
+					throw error_message( std::format( "File_archive: the member name '{}' is used more than once.", name( *twin ) ) );
+
+				Trailer						trailer{ m_offset, m_entries.size(), m_names.size(), {} };
+				std::memcpy( trailer.magic, magic, sizeof( magic ) );
+				write( m_entries.data(), m_entries.size()*sizeof( Entry ) );
+				write( m_names.data(), m_names.size() );
+				align();
+				write( &trailer, sizeof( Trailer ) );
+				m_out.close();
+			}
+		};
+
+	private:
+		Mapped_file							m_file{};
+		std::span< const Entry >			m_entries{};
+		std::string_view					m_names{};
+
+	public:
+		File_archive()										  = default;
+
+		/// Map the archive file path_. Throws if it is not an archive, or if it is truncated or corrupt.
+		/// All offsets and sizes are checked here, so the members can be accessed without checks.
+		explicit File_archive( const file_path & path_ ) : m_file{ path_ } {
+			const auto						bytes = m_file.bytes();
+			if( !is_archive( bytes ) )
+				throw error_message( "Not a file archive (or the wrong version)", path_ );
+			const std::size_t				end = bytes.size() - sizeof( Trailer );		// is_archive checks the size.
+			Trailer							trailer;
+			std::memcpy( &trailer, bytes.data() + end, sizeof( Trailer ) );
+
+			// Subtractions only, so that nothing can overflow.
+			if( std::memcmp( trailer.magic, magic, sizeof( magic ) ) 
+			 || ( trailer.index < sizeof( Head ) ) || ( trailer.index > end ) || ( trailer.index % alignof( Entry ) )
+			 || ( trailer.members > ( end - trailer.index )/sizeof( Entry ) )
+			 || ( trailer.names_size > end - trailer.index - trailer.members*sizeof( Entry ) ) )
+				throw error_message( "The file archive is truncated or corrupt", path_ );
+
+			// The file is page aligned and the index is 8 byte aligned.
+			m_entries					  = { reinterpret_cast< const Entry * >( bytes.data() + trailer.index ), trailer.members };
+			m_names						  = { reinterpret_cast< const char * >( m_entries.data() + m_entries.size() ), trailer.names_size };
+
+			// The members are before the index and the names are within the names.
+			for( const Entry & e : m_entries )
+				if( ( e.offset > trailer.index ) || ( e.size > trailer.index - e.offset ) 
+				 || ( e.name > m_names.size() ) || ( e.name_size > m_names.size() - e.name ) )
+					throw error_message( "The file archive has a corrupt index", path_ );
+		}
+
+		/// Do the bytes_ start like a file archive?
+		static bool is_archive( const std::span< const std::byte > bytes_ ) noexcept {
+			if( bytes_.size() < sizeof( Head ) + sizeof( Trailer ) )	return false;
+			Head							head;
+			std::memcpy( &head, bytes_.data(), sizeof( Head ) );
+			return !std::memcmp( head.magic, magic, sizeof( magic ) ) && ( head.version == version );
+		}
+
+		/// Is the file at path_ a file archive? Only its first bytes are read.
+		static bool is_archive( const std::filesystem::path & path_ ) {
+			std::array< std::byte, sizeof( Head ) + sizeof( Trailer ) >	bytes{};
+			std::ifstream					in{ path_, std::ios::in | std::ios::binary };
+			return in.read( reinterpret_cast< char * >( bytes.data() ), bytes.size() ) && is_archive( bytes );
+		}
+
+		/// The number of members.
+		std::size_t size()									const noexcept	{	return m_entries.size();	}
+
+		/// The name of member i_, in name order.
+		std::string_view name( const std::size_t i_ )		const noexcept	{
+			return m_names.substr( m_entries[ i_ ].name, m_entries[ i_ ].name_size );
+		}
+
+		/// The contents of member i_, in name order.
+		std::span< const std::byte > bytes( const std::size_t i_ )	const noexcept	{
+			return m_file.bytes().subspan( m_entries[ i_ ].offset, m_entries[ i_ ].size );
+		}
+
+		/// The index of the member name_, or size() if there is none.
+		std::size_t find( const std::string_view name_ )	const noexcept	{
+			std::size_t						i = std::lower_bound( m_entries.begin(), m_entries.end(), name_,
+				[ this ]( const Entry & e_, const std::string_view n_ ){
+					return m_names.substr( e_.name, e_.name_size ) < n_;
+				} ) - m_entries.begin();
+			return ( ( i < size() ) && ( name( i ) == name_ ) ) ? i : size();
+		}
+
+		/// Save the member name_ as the file dest_. Throws if there is no such member.
+		void extract( const std::string_view name_, const dest_path & dest_ )	const {
+			const std::size_t				i = find( name_ );
+			if( i == size() )
+				throw error_message( std::format( "File_archive: there is no member '{}'.", name_ ) );
+			Safe_ofstream< char >			out{ dest_, std::ios::out | std::ios::binary | std::ios::trunc };
+			out.write( reinterpret_cast< const char * >( bytes( i ).data() ), bytes( i ).size() );
+			out.close();
+		}
+	};
+
+	static_assert( sizeof( File_archive::Head ) == 16 );
+	static_assert( sizeof( File_archive::Entry ) == 32 );
+	static_assert( sizeof( File_archive::Trailer ) == 32 );
+
+}	// namespace pax
@@ -0,0 +1,80 @@
+//	Copyright (c) 2014-2016, Peder Axensten, all rights reserved.
+//	Contact: peder ( at ) axensten.se
+
+
+#pragma once
+
+#include "file.hpp"
+
+#include <sys/mman.h>	// mmap, munmap
+#include <fcntl.h>		// open
+#include <sys/stat.h>	// fstat
+#include <unistd.h>		// close
+
+#include <cstddef>		// std::byte
+#include <span>
+#include <utility>		// std::exchange
+
+
+namespace pax {
+
+	/// A read only memory map of a whole file.
+	/** The pages are shared by all processes that map the same file, so a large file that many
+		processes use at the same time is only read into memory once. 							**/
+	class Mapped_file {
+		const std::byte				  * m_data{};
+		std::size_t						m_size{};
+
+	public:
+		Mapped_file()											  = default;
+		Mapped_file( const Mapped_file & )						  = delete;
+		Mapped_file & operator=( const Mapped_file & )			  = delete;
+
+		Mapped_file( Mapped_file && other_ ) noexcept
+			: m_data{ std::exchange( other_.m_data, nullptr ) }, m_size{ std::exchange( other_.m_size, 0 ) } {}
+
+		Mapped_file & operator=( Mapped_file && other_ ) noexcept	{
+			std::swap( m_data, other_.m_data );
+			std::swap( m_size, other_.m_size );
+			return *this;
+		}
+
+		/// Map the file at path_. An empty file gives an empty map.
+		explicit Mapped_file( const file_path & path_ ) {
+			errno						  = 0;
+			const int					fd = ::open( path_.c_str(), O_RDONLY );
+			if( fd < 0 )
+				throw error_message( "Could not open file for mapping", path_, make_error_code( errno ) );
+
+			// fstat does not throw (as std::filesystem::file_size may), so fd is always closed.
+			struct stat					st{};
+			if( ::fstat( fd, &st ) ) {
+				const int				err = errno;
+				::close( fd );
+				throw error_message( "Could not get the size of file for mapping", path_, make_error_code( err ) );
+			}
+			m_size						  = std::size_t( st.st_size );
+			if( m_size ) {
+				void					  * ptr = ::mmap( nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0 );
+				const int					err = errno;
+				::close( fd );
+				if( ptr == MAP_FAILED ) {
+					m_size				  = 0;
+					throw error_message( "Could not map file", path_, make_error_code( err ) );
+				}
+				m_data					  = static_cast< const std::byte * >( ptr );
+			} else							::close( fd );
+		}
+
+		~Mapped_file() {
+			if( m_data )				::munmap( const_cast< std::byte * >( m_data ), m_size );
+		}
+
+		/// The contents of the file.
+		std::span< const std::byte > bytes()					const noexcept	{	return { m_data, m_size };	}
+		const std::byte * data()								const noexcept	{	return m_data;				}
+		std::size_t size()										const noexcept	{	return m_size;				}
+		explicit operator bool()								const noexcept	{	return m_data != nullptr;	}
+	};
+
+}	// namespace pax
@@ -0,0 +1,58 @@
+//	Copyright (c) 2014-2016, Peder Axensten, all rights reserved.
+//	Contact: peder ( at ) axensten.se
+
+
+#pragma once
+
+#include <algorithm>	// std::min
+#include <atomic>
+#include <exception>	// std::exception_ptr
+#include <mutex>
+#include <thread>		// std::jthread, std::thread::hardware_concurrency
+#include <vector>
+
+
+namespace pax {
+
+	/// The number of threads to use: threads_, or the hardware concurrency if threads_ is zero.
+	inline std::size_t thread_count( const std::size_t threads_ ) noexcept {
+		return threads_ ? threads_ : std::max( 1u, std::thread::hardware_concurrency() );
+	}
+
+
+	/// Call f_( i ) for each i in [0, n_), using at most threads_ threads (zero means the hardware concurrency).
+	/** - The calls are made in no particular order, but each i is handled exactly once. So f_ must be thread safe.
+		- With one thread (or n_ < 2), everything is done on the calling thread.
+		- If calls throw, the remaining items are skipped and the first exception is rethrown.	**/
+	template< typename F >
+	void parallel_for( const std::size_t n_, const std::size_t threads_, F && f_ ) {
+		const std::size_t					threads = std::min( thread_count( threads_ ), n_ );
+		if( threads < 2 ) {
+			for( std::size_t i{}; i<n_; ++i )	f_( i );
+			return;
+		}
+
+		std::atomic< std::size_t >			next{ 0 };
+		std::exception_ptr					error{};
+		std::mutex							error_mutex{};
+		const auto work = [ & ]() {
+			for( std::size_t i = next++; i < n_; i = next++ ) {
+				try {
+					f_( i );
+				} catch( ... ) {
+					const std::lock_guard	lock( error_mutex );
+					if( !error )			error = std::current_exception();
+					next					= n_;		// Skip the rest.
+				}
+			}
+		};
+		{
+			std::vector< std::jthread >		pool{};
+			pool.reserve( threads - 1 );
+			for( std::size_t t{ 1 }; t<threads; ++t )	pool.emplace_back( work );
+			work();		// The calling thread does its share.
+		}	// Joins the threads.
+		if( error )		std::rethrow_exception( error );
+	}
+
+}	// namespace pax
@@ -115,7 +115,7 @@ namespace pax {
 	};
 	
 	
-	Json_value concat_tables(
+	inline Json_value concat_tables(
 		const dir_path					  & source_,
 		const std::filesystem::path		  & dest_, 
 		const bool							verbose_ = false, 
@@ -0,0 +1,232 @@
+//	Copyright (c) 2014-2016, Peder Axensten, all rights reserved.
+//	Contact: peder ( at ) axensten.se
+
+
+#pragma once
+
+#include "text-table.hpp"
+#include "../std/mapped-file.hpp"
+#include "../textual/json.hpp"
+#include "../types/point-stuff/circle.hpp"
+
+#include <algorithm>	// std::sort, std::stable_sort, std::lower_bound
+#include <array>
+#include <cmath>		// std::ceil, std::floor, std::sqrt
+#include <cstdint>
+#include <cstring>		// std::memcmp, std::memcpy
+#include <numeric>		// std::iota
+
+
+namespace pax {
+
+	/// A binary, pre-parsed, version of a plots csv file, meant to be memory mapped.
+	/** A national plots file is read and tokenised once, when the catalogue is built, instead of once per
+		point cloud tile. Looking up the plots of a tile is logarithmic in the number of plots.
+		- The plots are sorted in horizontal bands (by north) and, within each band, by east.
+		- Each plot has its centre, radius, the original row text, and the index of that row.
+		- A table of plots has its rows in the original order, so the result is the same as with the csv file.
+		- The catalogue is in the native byte order, it is not meant to be moved between machines.
+
+		The file layout is:
+		- Plot_catalogue::Header.
+		- Band begins: std::uint64_t[ bands + 1 ], the first plot of each band.
+		- Plot_catalogue::Record[ plots ].
+		- Text: the header row and then all rows, each ending with '\n'.							**/
+	class Plot_catalogue {
+	public:
+		static constexpr char				magic[ 8 ]{ 'P', 'A', 'X', 'P', 'L', 'O', 'T', 'S' };
+		static constexpr std::uint32_t		version{ 2 };
+
+		struct Header {
+			char							magic[ 8 ];
+			std::uint32_t					version;
+			char							col_mark;
+			char							padding[ 3 ];
+			std::uint64_t					plots, bands;
+			double							y0, band_height, max_radius;
+			std::uint64_t					header_size;	// The header row, at the start of the text.
+		};
+
+		struct Record {
+			double							east, north, radius;
+			std::uint64_t					row;			// Offset of the row in the text.
+			std::uint64_t					row_size;		// Including the '\n'.
+			std::uint64_t					index;			// Row index in the original table.
+		};
+
+	private:
+		Mapped_file							m_file{};
+		Header								m_header{};
+		std::span< const std::uint64_t >	m_bands{};
+		std::span< const Record >			m_records{};
+		std::string_view					m_text{};
+
+		static std::size_t text_offset( const std::size_t plots_, const std::size_t bands_ ) noexcept {
+			return sizeof( Header ) + ( bands_ + 1 )*sizeof( std::uint64_t ) + plots_*sizeof( Record );
+		}
+
+		// The band of north_, clamped to the existing bands.
+		static std::size_t band( const Header & header_, const double north_ ) noexcept {
+			const double				b = std::floor( ( north_ - header_.y0 )/header_.band_height );
+			return std::size_t( std::clamp( b, 0.0, double( header_.bands - 1 ) ) );
+		}
+
+	public:
+		Plot_catalogue()									  = default;
+
+		/// Map the catalogue file path_. Throws if it is not a plot catalogue.
+		explicit Plot_catalogue( const file_path & path_ ) : m_file{ path_ } {
+			const auto					bytes = m_file.bytes();
+			if( !is_catalogue( bytes ) )
+				throw error_message( "Not a plot catalogue (or the wrong version)", path_ );
+			std::memcpy( &m_header, bytes.data(), sizeof( Header ) );
+			const std::size_t			text = text_offset( m_header.plots, m_header.bands );
+			if( ( m_header.bands == 0 ) || ( bytes.size() < text + m_header.header_size ) )
+				throw error_message( "The plot catalogue is truncated", path_ );
+
+			// The file is page aligned and everything up to the text is 8 byte aligned.
+			m_bands						  = { reinterpret_cast< const std::uint64_t * >( bytes.data() + sizeof( Header ) ),
+												m_header.bands + 1 };
+			m_records					  = { reinterpret_cast< const Record * >( m_bands.data() + m_bands.size() ),
+												m_header.plots };
+			m_text						  = { reinterpret_cast< const char * >( bytes.data() + text ), bytes.size() - text };
+		}
+
+		/// Do the bytes_ start like a plot catalogue?
+		static bool is_catalogue( const std::span< const std::byte > bytes_ ) noexcept {
+			if( bytes_.size() < sizeof( Header ) )				return false;
+			Header						header;
+			std::memcpy( &header, bytes_.data(), sizeof( Header ) );
+			return !std::memcmp( header.magic, magic, sizeof( magic ) ) && ( header.version == version );
+		}
+
+		/// Is the file at path_ a plot catalogue? Only its first bytes are read.
+		static bool is_catalogue( const std::filesystem::path & path_ ) {
+			std::array< std::byte, sizeof( Header ) >	bytes{};
+			std::ifstream				in{ path_, std::ios::in | std::ios::binary };
+			return in.read( reinterpret_cast< char * >( bytes.data() ), bytes.size() ) && is_catalogue( bytes );
+		}
+
+		/// The number of plots.
+		std::size_t size()									const noexcept	{	return m_records.size();	}
+
+		/// The column delimiter of the original table.
+		char col_mark()										const noexcept	{	return m_header.col_mark;	}
+
+		/// The header row of the original table, without the '\n'.
+		std::string_view header_row()						const noexcept	{	return m_text.substr( 0, m_header.header_size );	}
+
+		/// The text of the row of record_, including the '\n'.
+		std::string_view row( const Record & record_ )		const noexcept	{	return m_text.substr( record_.row, record_.row_size );	}
+
+		/// Call f_( record ) for all plots that might overlap box_: those with a centre within max radius of box_.
+		/// If the plots are enlarged by the user, radius_ is their largest radius (used if larger than max radius).
+		template< typename F >
+		void for_each( const Box< double, 2 > & box_, F && f_, const double radius_ = 0 )	const {
+			if( m_records.empty() )								return;
+			const double				r  = std::max( m_header.max_radius, radius_ );
+			const double				x0 = x( min( box_ ) ) - r, x1 = x( max( box_ ) ) + r;
+			const double				y0 = y( min( box_ ) ) - r, y1 = y( max( box_ ) ) + r;
+			for( std::size_t b = band( m_header, y0 ), b1 = band( m_header, y1 ); b <= b1; ++b ) {
+				const auto				records = m_records.subspan( m_bands[ b ], m_bands[ b + 1 ] - m_bands[ b ] );
+				auto					itr = std::lower_bound( records.begin(), records.end(), x0,
+											[]( const Record & rec_, const double x_ ){ return rec_.east < x_; } );
+				for( ; ( itr != records.end() ) && ( itr->east <= x1 ); ++itr )
+					if( ( itr->north >= y0 ) && ( itr->north <= y1 ) )	f_( *itr );
+			}
+		}
+
+		/// A text table of the plots that might overlap box_, with the original header and row text.
+		/// The rows are in the order of the original table. See for_each about radius_.
+		Text_table< char > table( const Box< double, 2 > & box_, const double radius_ = 0 )	const {
+			std::vector< const Record * >	found{};
+			for_each( box_, [ & ]( const Record & rec_ ){ found.push_back( &rec_ ); }, radius_ );
+			std::sort( found.begin(), found.end(), []( const Record * a_, const Record * b_ ){ return a_->index < b_->index; } );
+
+			std::string					text{ header_row() };
+			text						 += '\n';
+			for( const Record * rec : found )		text += row( *rec );
+			return Text_table< char >{ std::move( text ), m_header.col_mark };
+		}
+
+
+		/// Build a catalogue from the plots table file source_ and save it to dest_.
+		/// The table must have the columns 'east', 'north', and 'radius'.
+		static Json_value build( const file_path & source_, const dest_path & dest_ ) {
+			const Text_table< char >	table{ source_ };
+			const auto					circles = table.export_values( Object_meta< Circle< double, 2 > >::value );
+			const std::size_t			plots = circles.size();
+			const char					mark = table.col_mark();
+
+			// Bands of about sqrt( plots ) plots each.
+			double						y_min{ std::numeric_limits< double >::max() }, y_max{ std::numeric_limits< double >::lowest() };
+			double						max_radius{};
+			for( const auto & c : circles ) {
+				y_min					  = std::min( y_min, y( center( c ) ) );
+				y_max					  = std::max( y_max, y( center( c ) ) );
+				max_radius				  = std::max( max_radius, c.radius() );
+			}
+			Header						header{};
+			std::memcpy( header.magic, magic, sizeof( magic ) );
+			header.version				  = version;
+			header.col_mark				  = mark;
+			header.plots				  = plots;
+			header.bands				  = std::max( std::size_t( 1 ), std::size_t( std::ceil( std::sqrt( double( plots ) ) ) ) );
+			header.y0					  = plots ? y_min : 0.0;
+			header.band_height			  = ( plots && ( y_max > y_min ) ) ? ( y_max - y_min )/header.bands : 1.0;
+			header.max_radius			  = max_radius;
+
+			std::vector< std::size_t >	bands( plots ), order( plots );
+			for( std::size_t i{}; i<plots; ++i )	bands[ i ] = band( header, y( center( circles[ i ] ) ) );
+			std::iota( order.begin(), order.end(), std::size_t{} );
+			std::stable_sort( order.begin(), order.end(), [ & ]( const std::size_t a_, const std::size_t b_ ){
+				return ( bands[ a_ ] != bands[ b_ ] ) ? ( bands[ a_ ] < bands[ b_ ] )
+					: ( x( center( circles[ a_ ] ) ) < x( center( circles[ b_ ] ) ) );
+			} );
+
+			// The text: the header row and then the rows in catalogue order.
+			std::string					text{};
+			for( std::size_t c{}; c<table.cols(); ++c ) {
+				if( c )					text += mark;
+				text					 += table.header()[ c ];
+			}
+			header.header_size			  = text.size();
+			text						 += '\n';
+
+			std::vector< std::uint64_t >	band_begins( header.bands + 1, 0 );
+			std::vector< Record >		records{};
+			records.reserve( plots );
+			for( const std::size_t i : order ) {
+				const std::size_t		begin = text.size();
+				for( std::size_t c{}; c<table.cols(); ++c ) {
+					if( c )				text += mark;
+					text				 += table[ i, c ];
+				}
+				text					 += '\n';
+				records.push_back( { x( center( circles[ i ] ) ), y( center( circles[ i ] ) ), circles[ i ].radius(),
+					begin, text.size() - begin, i } );
+				++band_begins[ bands[ i ] + 1 ];
+			}
+			for( std::size_t b{}; b<header.bands; ++b )		band_begins[ b + 1 ] += band_begins[ b ];
+
+			// Save it.
+			Safe_ofstream< char >		out{ dest_, std::ios::out | std::ios::binary | std::ios::trunc };
+			out.write( reinterpret_cast< const char * >( &header ),				sizeof( Header ) );
+			out.write( reinterpret_cast< const char * >( band_begins.data() ),	band_begins.size()*sizeof( std::uint64_t ) );
+			out.write( reinterpret_cast< const char * >( records.data() ),		records.size()*sizeof( Record ) );
+			out.write( text.data(), text.size() );
+			out.close();
+
+			return Json_value{
+				{	"plots",			plots				},
+				{	"bands",			header.bands		},
+				{	"band-height",		header.band_height	},
+				{	"max-radius",		max_radius			}
+			};
+		}
+	};
+
+	static_assert( sizeof( Plot_catalogue::Header ) == 64 );
+	static_assert( sizeof( Plot_catalogue::Record ) == 48 );
+
+}	// namespace pax
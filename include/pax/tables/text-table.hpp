@@ -80,8 +80,12 @@ namespace pax {
 		constexpr Text_table( Text_table && )				=	default;
 		constexpr Text_table & operator=( Text_table && )	=	default;
 
-		/// Construct from a temporary string.
-		constexpr Text_table( std::basic_string< Ch > && str_ ) {
+		/// Construct from a temporary string, with the most probable column delimiter.
+		constexpr Text_table( std::basic_string< Ch > && str_ ) : Text_table{ std::move( str_ ), value_type{} } {}
+
+		/// Construct from a temporary string, with col_mark_ as column delimiter.
+		/// If col_mark_ is zero, the most probable column delimiter is used.
+		constexpr Text_table( std::basic_string< Ch > && str_, const value_type col_mark_ ) {
 			m_data.push_back( std::move( str_ ) );
 
 			// We *really* want to avoid small string optimization (sso). 
@@ -93,7 +97,8 @@ namespace pax {
 			// A good traitise on sso: https://devblogs.microsoft.com/oldnewthing/20230803-00/?p=108532
 			m_data.front().reserve( sizeof( std::string ) + 8 );
 
-			const auto[ cells, cols, col_mark ] = parse2table( std::basic_string_view( m_data.front() ) );
+			const std::basic_string_view	str{ m_data.front() };
+			const auto[ cells, cols, col_mark ] = ( col_mark_ == value_type{} ) ? parse2table( str ) : parse2table( str, col_mark_ );
 			const std::span 				cells_ref{ cells };
 			m_header					  = Header{ cells_ref.subspan( 0, cols ) };
 			m_table						  = Table< view_type >{ cells_ref.subspan( cols ), cols };
@@ -114,6 +119,9 @@ namespace pax {
 		
 		/// Access the header row.
 		constexpr const auto & header()					const noexcept	{	return m_header;				}
+
+		/// The column delimiter, as found when parsing.
+		constexpr value_type col_mark()					const noexcept	{	return m_col_mark;				}
 		
 		/// Get row r_ as a span.
 		constexpr auto row( const Size r_ )				const noexcept	{	return m_table.row( r_ );		}
@@ -271,36 +271,53 @@ namespace pax {
 
 
 
-	/// Parse a string into a table. Throws, if not all rows have the same number of columns.
+	/// Parse a string into a table, with col_mark_ as column separator. 
+	/// Throws, if not all rows have the same number of columns.
 	template< typename Ch, typename Traits >
 	std::tuple<
 		std::vector< std::basic_string_view< Ch, Traits > >,	///< All cells.
 		std::size_t, 											///< Number of columns per row.
 		Ch														///< Column separator mark.
-	> parse2table( const std::basic_string_view< Ch, Traits > str_ ) {
+	> parse2table( 
+		const std::basic_string_view< Ch, Traits > str_,
+		const Ch									col_mark_
+	) {
 		const String_meta					count( str_ );		// Get the string metadata. 
+		const auto							marks = count.statistics( col_mark_ );
 		
 		// Check if it is ok as a table.
-		if(	count.minimum_cols() != count.maximum_cols() )		// We have rows with varying number of cols...
+		if(	marks.min() != marks.max() )						// We have rows with varying number of cols...
 			throw user_error_message( std::format( 
 				"parse2table: Varying number of columns (smallest {}, largest {}).", 
-				count.minimum_cols(), 
-				count.maximum_cols()
+				1 + marks.min(), 
+				1 + marks.max()
 			) );
 
+		// Count columns in first row. (There is at least one column.) 
+		std::size_t							cols{ 1 };
+		for( const Ch c : until( str_, linebreak{} ) )
+			if( c == col_mark_ )			++cols;
+
 		// Read the columns, row by row.
 		std::vector< std::basic_string_view< Ch, Traits  > >	result;
-		result.reserve( count.non_empty_rows() * count.cols_in_first() );
+		result.reserve( count.non_empty_rows() * cols );
 		for( const auto row : String_view_splitter( str_, linebreak{} ) )  					// Iterate row by row.
 			if( row.size() ) 				 												// Skip empty rows
-				for( const auto cell : String_view_splitter( row, count.col_delimiter() ) )	// Iterate row cell by cell.
+				for( const auto cell : String_view_splitter( row, col_mark_ ) )				// Iterate row cell by cell.
 					result.push_back( make_view( cell ) );
 
-		return { 
-			result, 
-			count.cols_in_first(), 
-			count.col_delimiter()
-		};
+		return { result, cols, col_mark_ };
+	}
+
+	/// Parse a string into a table, with the most probable column separator. 
+	/// Throws, if not all rows have the same number of columns.
+	template< typename Ch, typename Traits >
+	std::tuple<
+		std::vector< std::basic_string_view< Ch, Traits > >,	///< All cells.
+		std::size_t, 											///< Number of columns per row.
+		Ch														///< Column separator mark.
+	> parse2table( const std::basic_string_view< Ch, Traits > str_ ) {
+		return parse2table( str_, Ch( String_meta( str_ ).col_delimiter() ) );
 	}
 
 
@@ -0,0 +1,108 @@
+//	Copyright (c) 2014-2016, Peder Axensten, all rights reserved.
+//	Contact: peder ( at ) axensten.se
+
+
+#pragma once
+
+#include "circle.hpp"
+
+#include <algorithm>	// std::sort, std::unique
+#include <cmath>		// std::pow
+#include <concepts>		// std::derived_from
+#include <cstdint>		// std::uint32_t
+#include <limits>
+#include <span>
+#include <vector>
+
+
+namespace pax {
+
+	/// A uniform grid over a Box, where each cell knows what circles overlap it.
+	/// It is used to find what circles/plots might contain a point, without testing all of them.
+	/// - The cells are at least as large as the largest circle diameter, so a circle overlaps
+	///   at most two cells in each dimension: the cells of the corners of its bounding box.
+	/// - The cells are also large enough that there are not many more cells than circles.
+	/// - The index of each circle is stored once per overlapping cell, contiguous per cell.
+	template< floating F, std::size_t N >							requires( is_static< N > )
+	class Circle_index {
+		using Grid					  = Box_indexer< F, N >;
+		using Pt					  = Point< F, N >;
+		using index_type			  = std::uint32_t;
+
+		Grid							m_grid{};
+		std::vector< index_type >		m_begins{};		// Cell i has the circles m_circles[ m_begins[ i ] ... m_begins[ i+1 ] ).
+		std::vector< index_type >		m_circles{};
+
+		// The side of the cells: the largest diameter, but not so small that there are many more cells than circles.
+		template< typename C >
+		static F cell_side( const Box< F, N > & box_, const std::span< const C > circles_ ) noexcept {
+			F							diameter{};
+			for( const auto & c : circles_ )	diameter = std::max( diameter, 2*c.radius() );
+
+			F							volume{ 1 };
+			for( const auto s : box_.sides() )	volume *= ( s > 0 ) ? s : F{ 1 };
+			const F						min_side = std::pow( volume/( 4*circles_.size() + 1 ), F( 1 )/N );
+			return std::max( { diameter, min_side, std::numeric_limits< F >::min() } );
+		}
+
+		// The cell of pt_, clamped to the grid.
+		constexpr std::size_t cell( const Pt & pt_ )				const noexcept	{
+			return m_grid.scalar_index( pax::min( pax::max( pt_, m_grid.min() ), m_grid.max() ) );
+		}
+
+	public:
+		constexpr Circle_index()								  = default;
+		constexpr Circle_index( const Circle_index & )			  = default;
+		constexpr Circle_index( Circle_index && )				  = default;
+		constexpr Circle_index & operator=( const Circle_index & )= default;
+		constexpr Circle_index & operator=( Circle_index && )	  = default;
+
+		/// Index the circles_ within box_. Circles partially outside box_ are indexed in the edge cells.
+		/// Circles entirely outside box_ are indexed too, but no point can be found for them.
+		template< typename C >										requires( std::derived_from< C, Circle< F, N > > )
+		Circle_index( const Box< F, N > & box_, const std::span< const C > circles_ )
+			: m_grid{ box_, cell_side( box_, circles_ ) }
+		{
+			// For each circle, the cells of its bounding box corners, as ( cell, circle ) pairs.
+			std::vector< std::pair< index_type, index_type > >	pairs{};
+			pairs.reserve( circles_.size() * ( 1u << N ) );
+			for( std::size_t c{}; c<circles_.size(); ++c ) {
+				const Pt				lo = min( circles_[ c ] ), hi = max( circles_[ c ] );
+				for( std::size_t corner{}; corner < ( 1u << N ); ++corner ) {
+					Pt					pt;
+					for( std::size_t d{}; d<N; ++d )	pt[ d ] = ( corner & ( 1u << d ) ) ? hi[ d ] : lo[ d ];
+					pairs.emplace_back( index_type( cell( pt ) ), index_type( c ) );
+				}
+			}
+			std::sort( pairs.begin(), pairs.end() );
+			pairs.erase( std::unique( pairs.begin(), pairs.end() ), pairs.end() );
+
+			// Lay them out contiguously per cell.
+			m_begins.assign( m_grid.elements() + 1, 0 );
+			m_circles.reserve( pairs.size() );
+			for( const auto & [ c, circle ] : pairs ) {
+				++m_begins[ c + 1 ];
+				m_circles.push_back( circle );
+			}
+			for( std::size_t i{}; i<m_grid.elements(); ++i )	m_begins[ i + 1 ] += m_begins[ i ];
+		}
+
+		/// The indices of the circles that might contain pt_, in increasing order.
+		/// Returns an empty span if pt_ is outside the grid, with a single lookup.
+		constexpr std::span< const index_type > operator()( const Pt & pt_ )	const noexcept	{
+			if( m_circles.empty() || !m_grid.inside_or_on( pt_ ) )		return {};
+			const auto				i = m_grid.scalar_index( pt_ );
+			return std::span( m_circles ).subspan( m_begins[ i ], m_begins[ i + 1 ] - m_begins[ i ] );
+		}
+
+		/// The number of cells in the grid.
+		constexpr std::size_t cells()								const noexcept	{	return m_grid.elements();	}
+
+		/// The grid.
+		constexpr const Grid & grid()								const noexcept	{	return m_grid;				}
+	};
+
+	template< floating F, std::size_t N, typename C >
+	Circle_index( const Box< F, N > &, std::span< const C > ) -> Circle_index< F, N >;
+
+}	// namespace pax
@@ -1,13 +1,19 @@
 #include <pax/pdal/modules/pdal_plugin_filter_plot_stuff.hpp>
 #include <pax/pdal/utilities/pdal.hpp>
+#include <pax/std/parallel.hpp>
+#include <pax/pdal/utilities/plot-metrics.hpp>
+#include <pax/tables/plot-catalogue.hpp>
+#include <pax/std/file-archive.hpp>
 
 #include <pdal/util/FileUtils.hpp>
 #include <pdal/util/ProgramArgs.hpp>
 #include <pdal/StageFactory.hpp>
 #include <pdal/io/BufferReader.hpp>
 
+#include <algorithm>		// std::stable_partition, std::ranges::any_of, adjacent_find, replace, sort
+#include <mutex>
+#include <optional>
 #include <unordered_map>
-#include <unordered_set>
 
 
 
@@ -26,14 +32,16 @@ std::string pax::plot_stuff::getName()	const	{	return s_info.name;		}
 
 namespace pax {
 
-	plot_stuff::~plot_stuff() {}
+	plot_stuff::~plot_stuff()		{	View_bounds::forget( *this );	}
 
 
-	// This is what prevents this filter to be streaming. 
-	// I can not get the metadata/headerinfo of the files to be processed...
+	// When not streaming, the plots are selected by the bounds of the view (passed on, as the view is not changed).
 	void plot_stuff::setting_needs_PointView( pdal::PointViewPtr view_ptr_ ) {
+		const auto						bbox = box( *this, *view_ptr_ );
+		View_bounds::remember( *this, *view_ptr_, bbox );
 		m_view_ptr						  = view_ptr_;
-		m_plots							  = get_plots( view_ptr_ );
+		m_plots							  = get_plots( bbox, view_ptr_->layout() );
+		m_plot_index					  = Circle_index{ bbox, std::span< const Plot_w_points >( m_plots ) };
 	}
 
 
@@ -43,13 +51,21 @@ namespace pax {
 
 		// setPositional() Makes the argument required.
 		args.add( "plot_file", 			"File path to a csv-type file with at least the required columns 'north', 'east', "
-										"'radius' and 'id'. Plots not entirely within the point cloud bounding box are ignored. ",
+										"'radius' and 'id'. Plots not entirely within the point cloud bounding box are ignored, "
+										"unless 'plot_partials_dest' is given. "
+										"It may also be a plot catalogue, as created by pax-plot-catalogue from such a file. ",
 											m_plot_file ).setPositional();
 		args.add( "plot_points_dest",	"Destination path (to a directory) for the plot point cloud files. ", 
 											m_points_dest_dir ).setPositional();
+		args.add( "plot_points_archive",	"Destination path (to a file) for a single archive with all the plot point cloud files, "
+										"instead of saving them individually in 'plot_points_dest'. Extract them with pax-plot-archive. ", 
+											m_points_archive, m_points_archive );
 		args.add( "plot_metrics_dest",	"Destination path (to a file) for the plot metrics csv files. ", 
 											m_metrics_dest ).setPositional();
 		args.add( "metrics", 			metrics_help_stream.str(), m_metrics ).setPositional();
+		args.add( "plot_partials_dest",	"Destination path (to a file) for the values of plots partially within the point cloud. "
+										"Merge the files of all point clouds with pax-merge-plot-partials to get their metrics. ", 
+											m_partials_dest, m_partials_dest );
 		args.add( "nilsson_level", 		"For some metrics, ignore z-values below this. ", m_metrics_nilsson, m_metrics_nilsson );
 		args.add( "points_format",		"File format to use for resulting plot point clud files (e.g '.laz'). ", 
 											m_points_format, m_points_format );
@@ -57,39 +73,76 @@ namespace pax {
 											m_id_column, m_id_column );
 		args.add( "plot_buffer",		"How much to enlarge the plot diameters. A zero value (the default) will use the plot diameter. ",
 											m_plot_buffer, m_plot_buffer );
+		args.add( "plot_radii",			"Concentric radii to calculate metrics for, e.g. '[0, 12, 15]'. Zero means the plot radius. "
+										"Each radius gets its own metric columns. Points are saved for the largest radius. ",
+											m_plot_radii );
+		args.add( "threads",			"The number of threads to use when saving plot point clouds. Zero means as many as there are cores. ", 
+											m_threads, m_threads );
+		args.add( "bounds",				"Only used when streaming: the bounds of the point cloud, as '([minx, maxx], [miny, maxy])'. "
+										"Takes precedence over the las header bounds. Required if there are no header bounds, "
+										"or if an earlier stage moves the points (e.g. filters.reprojection), as the header bounds are then wrong. ", 
+											m_bounds );
 	}
 
 
 	// Read a plot file and return a vector of the plots in the bbox.
-	std::vector< Plot_w_points > plot_stuff::get_plots( pdal::PointViewPtr view_ptr_ ) {
+	// The plots entirely within bbox come first, then (if do_partials()) the plots partially within it.
+	std::vector< Plot_w_points > plot_stuff::get_plots(
+		const Box< double, 2 >			  & bbox, 
+		const pdal::PointLayoutPtr		  & layout_
+	) {
 		using Plot_w_id					  = Circle_w_id< double, 2 >;
-
-		const auto							bbox = box( *view_ptr_ );
 		std::vector< Plot_w_points >		plots{};
+		m_full_plots					  = 0;
 
-		// First, read in all plots from the csv file.
-		if( ( do_metrics() || do_points() ) && !empty( bbox ) ) {	
-			const auto height_dim		  = view_ptr_->hasDim( pdal::Dimension::Id::HeightAboveGround )
+		// First, read in all plots from the csv file (or the plots near bbox from a plot catalogue).
+		if( do_plots() && !empty( bbox ) ) {	
+			const auto height_dim		  = layout_->hasDim( pdal::Dimension::Id::HeightAboveGround )
 									  	  ? pdal::Dimension::Id::HeightAboveGround : pdal::Dimension::Id::Z;
-			const bool has_return_number  = view_ptr_->hasDim( pdal::Dimension::Id::ReturnNumber );
-			m_all_plots_table			  =	Text_table< char >{ m_plot_file };
+			const bool has_return_number  = layout_->hasDim( pdal::Dimension::Id::ReturnNumber );
+			// A plot catalogue (see pax-plot-catalogue) only gives the plots near bbox, without parsing the others.
+			// Plots may be enlarged by plot_buffer or plot_radii, so they are looked for within the largest of those too.
+			double max_radius			  = m_plot_buffer;
+			for( const double r : m_plot_radii )	max_radius = std::max( max_radius, r );
+			m_all_plots_table			  =	Plot_catalogue::is_catalogue( m_plot_file )
+										  ? Plot_catalogue{ m_plot_file }.table( bbox, max_radius )
+										  : Text_table< char >{ m_plot_file };
 			std::vector< Plot_w_id >		basic_plots 
 				= m_all_plots_table.export_values( Object_meta< Plot_w_id >::value );
 	
-			// Then, only keep the plots that overlap the bbox.
-			// Copy the relevant plots to the begining of 'plots' and...
-			auto itr					  = basic_plots.begin();
-			for( Plot_w_id & plot : basic_plots )
-				if( contains( bbox, plot ) )  * ( itr++ ) = plot;
+			// Use plot_buffer, if given, as plot radius.
+			if( m_plot_buffer > 0 )
+				for( auto & plot : basic_plots )	plot = Plot_w_id( center( plot ), m_plot_buffer, plot.id() );
+
+			// The radii to calculate metrics for (zero is the plot radius) and the largest of them. 
+			const auto radii			  = [ this ]( const Plot_w_id & plot ) {
+				std::vector< double >		result{};
+				for( const double r : m_plot_radii )	result.push_back( ( r > 0 ) ? r : plot.radius() );
+				return result;
+			};
+			const auto outer			  = [ & ]( const Plot_w_id & plot ) {
+				const auto					r = radii( plot );
+				return r.empty() ? plot : Plot_w_id( center( plot ), std::ranges::max( r ), plot.id() );
+			};
+
+			// Then, only keep the plots that are within the bbox, followed by those that overlap it.
+			// The order is stable, so the partial plots also keep their table order.
+			const auto partial			  = std::stable_partition( basic_plots.begin(), basic_plots.end(), 
+				[ & ]( const Plot_w_id & plot ){ return contains( bbox, outer( plot ) ); } );
+			const auto end				  = do_partials() ? std::stable_partition( partial, basic_plots.end(), 
+				[ & ]( const Plot_w_id & plot ){ return overlap( bbox, outer( plot ) ); } ) : partial;
+			m_full_plots				  = std::size_t( partial - basic_plots.begin() );
 
 			// ...resize it to contain just those relevant plots.
-			basic_plots.resize( std::size_t( itr - basic_plots.begin() ) );
+			basic_plots.resize( std::size_t( end - basic_plots.begin() ) );
 			plots.reserve( basic_plots.size() );
 
-			// Now, create the Plot_w_points vector.
-			for( Plot_w_id & plot : basic_plots ) {
-				if( m_plot_buffer > 0 )		plot = Plot_w_id( center( plot ), m_plot_buffer, plot.id() );
-				plots.emplace_back( plot, do_metrics(), do_points(), has_return_number, height_dim );
+			// Now, create the Plot_w_points vector. The points of partial plots are not saved, only their values.
+			for( std::size_t i{}; i<basic_plots.size(); ++i ) {
+				const bool					is_full = ( i < m_full_plots );
+				plots.emplace_back( outer( basic_plots[ i ] ), radii( basic_plots[ i ] ), 
+					do_metrics() || !is_full, do_points() && is_full, has_return_number, height_dim, 
+					m_streaming ? &m_packing : nullptr );
 			}
 		}
 		return plots;
@@ -102,26 +155,60 @@ namespace pax {
 			<< "\n\tPlot stuff arguments:" 
 			<< "\n\tplot_file:         " << m_plot_file
 			<< "\n\tplot_points_dest:  " << m_points_dest_dir
+			<< "\n\tplot_points_archive:" << m_points_archive
 			<< "\n\tplot_metrics_dest: " << m_metrics_dest
+			<< "\n\tplot_partials_dest:" << m_partials_dest
 			<< "\n\tnilsson_level:     " << m_metrics_nilsson
 			<< "\n\tpoints_format:     " << m_points_format
 			<< "\n\tid_column:         " << m_id_column
 			<< "\n\tplot_buffer:       " << m_plot_buffer
+			<< "\n\tplot_radii:        " << std::format( "{}", m_plot_radii )
+			<< "\n\tthreads:           " << m_threads
+			<< "\n\tbounds:            " << m_bounds
 			<< "\n\tmetrics:           " << std::format( "{}", m_metrics )
 			<< "\n";
 	}
 
 
 	/// Do pre-flight stuff.
-	void plot_stuff::ready( pdal::PointTableRef /*pt_table_*/ ) {
+	void plot_stuff::ready( pdal::PointTableRef table_ ) {
 		// Check argumeents.
 		if( m_plot_buffer < 0 )				m_plot_buffer = 0;;
+		if( ( m_plot_radii.size() > 1 ) && do_partials() )
+			throwError( "Several 'plot_radii' can not be combined with 'plot_partials_dest'." );
+		if( m_points_dest_dir.find( '#' ) != std::string::npos )
+			throwError( "The 'plot_points_dest' path may not contain '#'." );
+		if( std::ranges::any_of( m_plot_radii, []( const double r_ ){ return !( r_ >= 0 ); } ) )
+			throwError( std::format( "The 'plot_radii' must be positive or zero (the plot radius), got {}.", m_plot_radii ) );
+		std::vector< double >				radii = m_plot_radii;
+		std::ranges::sort( radii );
+		if( std::ranges::adjacent_find( radii ) != radii.end() )
+			throwError( std::format( "The 'plot_radii' may not have duplicates, as each radius gets its own columns, got {}.", m_plot_radii ) );
+
+		// When streaming, there is no view to get the bounds from or to keep point ids into. 
+		// So we select the plots here and keep copies of the plot points. Explicit bounds take precedence 
+		// over the header bounds, which are those of the file and not of the points after e.g. a reprojection.
+		m_streaming						  = !table_.supportsView();
+		if( m_streaming ) {
+			const auto						header = header_box( table_ );
+			if( !header && m_bounds.empty() )
+				throwError( "When streaming, either the las header bounds or the argument 'bounds' is required." );
+			const auto						bbox = m_bounds.empty() ? *header : box( m_bounds );
+
+			m_packing.layout			  = table_.layout();
+			m_packing.dims				  = m_packing.layout->dimTypes();
+			m_packing.size				  = m_packing.layout->pointSize();
+			m_packing.srs				  = table_.anySpatialReference();
+			m_plots						  = get_plots( bbox, m_packing.layout );
+			m_plot_index				  = Circle_index{ bbox, std::span< const Plot_w_points >( m_plots ) };
+		}
 	}
 
 
 	bool plot_stuff::processOne( pdal::PointRef & pt_ ) {
 		++m_metadata.points_processed;
-		for( auto & plot : m_plots )		m_metadata.points_in_plots += plot.process( pt_ );
+		for( const auto i : m_plot_index( point( pt_ ) ) )
+			m_metadata.points_in_plots	 += m_plots[ i ].process( pt_ );
 		return true;
 	}
 
@@ -129,8 +216,8 @@ namespace pax {
 	pdal::PointViewSet plot_stuff::run( pdal::PointViewPtr view_ptr_ ) {
 		setting_needs_PointView( view_ptr_ );
 
-		// Process the points.
-		if( do_points() || do_points() ) {
+		// Process the points. Also if only partial plots are saved, as they need the point values.
+		if( do_plots() ) {
 			auto pt = view_ptr_->point( 0 );
 			for( pdal::PointId idx = 0; idx < view_ptr_->size(); ++idx ) {
 				pt = view_ptr_->point( idx );
@@ -145,14 +232,37 @@ namespace pax {
 	}
 
 
+	/// The suffixes of the metric column names, one for each of m_plot_radii. None, if there are not several radii.
+	/// The plot radius (zero) has no suffix, the others are like '_r12' or '_r12_5' (for 12.5).
+	std::vector< std::string > plot_stuff::radius_suffixes()	const {
+		std::vector< std::string >			result{};
+		if( m_plot_radii.size() > 1 ) {
+			for( const double radius : m_plot_radii ) {
+				std::string					suffix = ( radius > 0 ) ? std::format( "_r{}", radius ) : std::string{};
+				std::ranges::replace( suffix, '.', '_' );
+				result.push_back( std::move( suffix ) );
+			}
+		}
+		return result;
+	}
+
+
+	/// The rows of plots_table_ of each of plots_, in table order, and their aggregators. Throws if not all are found.
+	inline std::vector< Plot_row > plot_rows(
+		const Text_table< char >						  & plots_table_,
+		const std::span< Plot_w_points >					plots_,
+		const std::string_view								id_col_name_ = "id"
+	);
+
 	/// Seve the metrics from each plot to a .csv file, not discarding previous columns. 
-	/// It is a bit roundabout, but we need to include the other columns.
+	/// The rows are written directly, with the metrics appended to (or replacing) the original row text.
 	inline void save_metrics(
 		const Text_table< char >						  & plots_table_,
 		const std::span< Plot_w_points >					plots_,
 		const dest_path									  & plot_metrics_dest_,
 		const std::span< const metrics::Function_filter >	metrics_,
-		const std::string_view								id_col_name_ = "id"
+		const std::string_view								id_col_name_ = "id",
+		const std::span< const std::string >				suffixes_ = {}
 	);
 
 
@@ -161,17 +271,42 @@ namespace pax {
 			// Calculate and save metrics.
 			if( do_metrics() ) {
 				const auto metric_set		  = metrics::metric_set( std::span{ m_metrics }, m_metrics_nilsson );
-				save_metrics( m_all_plots_table, m_plots, m_metrics_dest, metric_set, m_id_column );
+				save_metrics( m_all_plots_table, full_plots(), m_metrics_dest, metric_set, m_id_column, radius_suffixes() );
 			}
 
-			// Seve the plots' points.
+			// Save the values of the partial plots, to be merged with those of other point clouds.
+			if( do_partials() && m_all_plots_table.cols() ) {
+				const auto partials			  = std::span( m_plots ).subspan( m_full_plots );
+				save_partial_rows( m_all_plots_table, plot_rows( m_all_plots_table, partials, m_id_column ), m_partials_dest );
+			}
+
+			// Seve the plots' points. The plots are split in one set per thread, each set is saved by a single writer.
+			// To an archive: the files are written to the temporary directory and then appended to the archive.
 			if( do_points() ) {
-				for( const auto & plot : m_plots )	if( plot.num_of_points() )				
-					plot.save_plot_points( 
-						m_view_ptr, 
-						m_points_dest_dir, 
-						m_points_format 
-					);
+				std::optional< File_archive::Writer >	archive{};
+				std::mutex					archive_mutex{};
+				if( !m_points_archive.empty() )	archive.emplace( m_points_archive );
+				const dir_path				dir = archive ? std::filesystem::temp_directory_path() 
+											: std::filesystem::path( m_points_dest_dir );
+				const auto saved			  = [ & ]( const std::string & name_, const std::filesystem::path & file_ ) {
+					if( archive ) {
+						{
+							const std::lock_guard	lock( archive_mutex );
+							archive->append_file( name_, file_ );
+						}
+						std::filesystem::remove( file_ );
+					} else					std::filesystem::rename( file_, dir / name_ );
+				};
+
+				const std::size_t			sets = std::min( thread_count( m_threads ), m_full_plots );
+				parallel_for( sets, m_threads, [ & ]( const std::size_t s ) {
+					const std::size_t		begin = s*m_full_plots/sets, end = ( s + 1 )*m_full_plots/sets;
+					save_plot_points( std::span< const Plot_w_points >( m_plots ).subspan( begin, end - begin ), dir, saved );
+				} );
+				if( archive ) {
+					m_metadata.plots_archived = archive->size();
+					archive->close();
+				}
 			}
 		} catch( const std::exception & error_ ) {
 			std::cerr << error_.what() << '\n';
@@ -184,178 +319,211 @@ namespace pax {
 		pdal::MetadataNode					arguments( "arguments" );
 		arguments.add( "plot_file",			to_string( m_plot_file ) );
 		arguments.add( "plot_points_dest",	to_string( m_points_dest_dir ) );
+		arguments.add( "plot_points_archive",	to_string( m_points_archive ) );
 		arguments.add( "plot_metrics_dest",	to_string( m_metrics_dest ) );
+		arguments.add( "plot_partials_dest",to_string( m_partials_dest ) );
 		for( const auto & metric : m_metrics )	arguments.add( "metrics",	metric );
 		arguments.add( "nilsson_level", 	m_metrics_nilsson );
 		arguments.add( "points_format",		m_points_format );
 		arguments.add( "id_column",			m_id_column );
 		arguments.add( "plot_buffer",		m_plot_buffer );
+		for( const auto radius : m_plot_radii )	arguments.add( "plot_radii",	radius );
+		arguments.add( "threads",			m_threads );
 		meta.add( arguments );
 
 		pdal::MetadataNode					result( "result" );
-		result.add( "plots-processed",		m_plots.size() );
+		result.add( "streaming",			m_streaming );
+		result.add( "plots-processed",		m_full_plots );		// Only plots entirely within the point cloud.
+		result.add( "partial-plots",		m_plots.size() - m_full_plots );	// Saved to plot_partials_dest.
 		result.add( "points-processed",		m_metadata.points_processed );
 		result.add( "points-in-plots",		m_metadata.points_in_plots );
+		result.add( "plots-archived",		m_metadata.plots_archived );
 		meta.add( result );
 	}
 
 
 
 	/// Process a point. Return true if it was inside the plot.
+	/// The squared distance is calculated once and used for all radii.
 	bool Plot_w_points::process( const pdal::PointRef & pt_ ) 			noexcept		{
-		if( contains( *this, point( pt_ ) ) ) {
-			if( m_do_points )			m_points_idx.push_back( pt_.pointId() );
-			if( m_do_metrics )			m_metric_agg.push_back(
-				pt_.getFieldAs< coord_type >( m_height_dimension ),
-				!m_has_return_number || pt_.getFieldAs<std::uint8_t>(pdal::Dimension::Id::ReturnNumber) == 1
-			);
+		if( const auto d2 = distance2( center( *this ), point( pt_ ) ); d2 <= radius()*radius() ) {
+			if( m_do_points ) {
+				if( m_packing ) {
+					const std::size_t	end = m_packed.size();
+					m_packed.resize( end + m_packing->size );
+					pt_.getPackedData( m_packing->dims, m_packed.data() + end );
+				} else					m_points_idx.push_back( pt_.pointId() );
+			}
+			if( m_do_metrics ) {
+				const auto				z = pt_.getFieldAs< coord_type >( m_height_dimension );
+				const bool				is_first = !m_has_return_number 
+										|| pt_.getFieldAs<std::uint8_t>(pdal::Dimension::Id::ReturnNumber) == 1;
+				for( std::size_t r{}; r<m_radii2.size(); ++r )
+					if( d2 <= m_radii2[ r ] )	m_metric_aggs[ r ].push_back( z, is_first );
+			}
 			return true;
 		}
 		return false;
 	}
 
 
-	/// Save the points of each found plot.
-	void Plot_w_points::save_plot_points( 
+	/// Append the points of the plot to dest_, a view with the dimensions dims_.
+	void Plot_w_points::append_points( 
 		const pdal::PointViewPtr		  & view_ptr_,
-		const dir_path					  & plot_points_dest_dir_,
-		std::string_view					plot_points_file_format_
+		const pdal::DimTypeList			  & src_dims_,
+		const pdal::DimTypeList			  & dims_,
+		pdal::PointView					  & dest_
 	) const {
-		const std::filesystem::path	plot_points_dest   
-			  = plot_points_dest_dir_ / ( Plot_w_id::id() + plot_points_file_format_ );
-		try{
-			if( m_do_points && !m_points_idx.empty() && !plot_points_dest_dir_.empty() ) {
-				// Create a new view and add the plot's points to it. 
-				pdal::PointViewPtr				points{ view_ptr_->makeNew() };
-				pdal::PointRef					pt( *view_ptr_, 0 );
-				for( pdal::PointId idx : m_points_idx ) {
-					pt.setPointId( idx );
-					points->appendPoint( *view_ptr_, pt.pointId() );
-				}
+		pdal::PointId						i = dest_.size();
+		if( m_packing ) {
+			for( std::size_t p{}; p<num_of_points(); ++p )
+				dest_.setPackedPoint( dims_, i++, m_packed.data() + p*m_packing->size );
+		} else {
+			std::vector< char >				buffer( view_ptr_->layout()->pointSize() );
+			for( const pdal::PointId idx : m_points_idx ) {
+				view_ptr_->getPackedPoint( src_dims_, idx, buffer.data() );
+				dest_.setPackedPoint( dims_, i++, buffer.data() );
+			}
+		}
+	}
 
-				// Save the view to a file.
-				static constexpr const char *	las_suffix  = ".las";
-				static constexpr const char *	laz_suffix  = ".laz";
-				pdal::Options					options;
-				options.add( "filename", plot_points_dest.native() );
-				if( plot_points_file_format_ == laz_suffix ) {
-					options.add( "compression",	"laszip" );
-					plot_points_file_format_  = las_suffix;
-				}
 
-				pdal::BufferReader				reader;
-				reader.addView( points );
-
-				// StageFactory always "owns" the stages it creates. They'll be destroyed with the factory.
-				pdal::StageFactory				factory;
-				// Next line can not be "writers.laz", but must in that case be "writers.las".
-				pdal::Stage					  * writer = factory.createStage( std::string( "writers" ) + plot_points_file_format_ );
-				writer->setInput( reader );
-				writer->setOptions( options );
-				writer->prepare( points->table() );
-				writer->execute( points->table() );
+	/// Save the point clouds of plots_ (those with any points) to files in dir_, and call saved_( name, file ) for each.
+	/** There is one table, one view per plot, and one writer for all of plots_, so the stage setup is done once.
+		The writer saves each view to a file of its own, numbered in view order (the '#' in the file name). 
+		So dir_ may not contain a '#'. 
+		The name is the plot id plus m_points_format, saved_ must move or remove the file.
+		Plots are saved concurrently by calling this for disjoint sets of plots, nothing is shared between the calls. **/
+	void plot_stuff::save_plot_points( 
+		const std::span< const Plot_w_points >	plots_,
+		const dir_path						  & dir_,
+		const std::function< void( const std::string &, const std::filesystem::path & ) > & saved_
+	) const {
+		std::vector< std::string_view >		ids{};				// The plot of each view, in view order.
+		std::filesystem::path				numbered{};
+		const auto numbered_file = [ & ]( const std::size_t n_ ) {
+			std::string						name = numbered.filename().native();
+			return numbered.parent_path() / name.replace( name.find( '#' ), 1, std::to_string( n_ ) );
+		};
+
+		try{
+			// A new table, with the same dimensions in the same order as the source. 
+			// Nothing (not even the metadata) is shared with the original table.
+			const pdal::PointLayoutPtr		src_layout = m_streaming ? m_packing.layout : m_view_ptr->layout();
+			const pdal::DimTypeList			src_dims   = m_streaming ? m_packing.dims   : src_layout->dimTypes();
+			pdal::PointTable				table;
+			pdal::DimTypeList				dims{};
+			for( const auto & dim : src_dims )
+				dims.emplace_back( table.layout()->registerOrAssignDim( 
+					src_layout->dimName( dim.m_id ), dim.m_type ), dim.m_type );
+			table.finalize();
+			table.addSpatialReference( m_streaming ? m_packing.srs : m_view_ptr->spatialReference() );
+
+			// A view for each plot. The views are written in the order they are created.
+			pdal::BufferReader				reader;
+			for( const auto & plot : plots_ ) {
+				if( plot.num_of_points() ) {
+					pdal::PointViewPtr		points = std::make_shared< pdal::PointView >( table );
+					plot.append_points( m_view_ptr, src_dims, dims, *points );
+					reader.addView( points );
+					ids.push_back( plot.id() );
+				}
 			}
+			if( ids.empty() )				return;
+
+			// The first plot id makes the numbered files unique, also when tiles are processed concurrently.
+			// PDAL numbers the files at the first '#', so there must be no other: any '#' in the id is replaced.
+			if( to_string( dir_ ).find( '#' ) != std::string::npos )
+				throw error_message( "The directory path may not contain '#'" );
+			std::string						format = m_points_format;
+			std::string						prefix{ ids.front() };
+			std::ranges::replace( prefix, '#', '_' );
+			numbered					  = dir_ / ( prefix + ".part-#" + format );
+
+			static constexpr const char *	las_suffix  = ".las";
+			static constexpr const char *	laz_suffix  = ".laz";
+			pdal::Options					options;
+			options.add( "filename", numbered.native() );
+			if( format == laz_suffix ) {
+				options.add( "compression",	"laszip" );
+				format					  = las_suffix;
+			}
+
+			// StageFactory always "owns" the stages it creates. They'll be destroyed with the factory.
+			pdal::StageFactory				factory;
+			// Next line can not be "writers.laz", but must in that case be "writers.las".
+			pdal::Stage					  * writer = factory.createStage( "writers" + format );
+			writer->setInput( reader );
+			writer->setOptions( options );
+			writer->prepare( table );
+			writer->execute( table );
+
+			// The writer numbers the files from 1.
+			for( std::size_t i{}; i<ids.size(); ++i )
+				saved_( std::string( ids[ i ] ) + m_points_format, numbered_file( i + 1 ) );
 		} catch( const std::exception & error_ ) {
-			throw error_message( std::format( "Plot_w_points: {}. (Saving point cloud of plot '{}' to file '{}'.)",
-				error_.what(), Plot_w_id::id(), to_string( plot_points_dest )
+			std::error_code					ec;
+			if( !numbered.empty() )
+				for( std::size_t i{}; i<ids.size(); ++i )	std::filesystem::remove( numbered_file( i + 1 ), ec );
+			throw error_message( std::format( "plot_stuff: {}. (Saving point clouds of {} plots, the first is '{}', to '{}'.)",
+				error_.what(), ids.size(), ids.empty() ? std::string_view{} : ids.front(), to_string( dir_ )
+			) );
+		}
+	}
+
+	
+	/// The rows of plots_table_ of each of plots_, in table order, and their aggregators. Throws if not all are found.
+	inline std::vector< Plot_row > plot_rows(
+		const Text_table< char >						  & plots_table_,
+		const std::span< Plot_w_points >					plots_,
+		const std::string_view								id_col_name_
+	) {
+		const std::size_t 					id_col = plots_table_.header().index( id_col_name_ );
+		if( id_col >= plots_table_.cols() )
+			throw error_message( std::format( "In the plots table, there is no column \"{}\".", id_col_name_ ) );
+
+		// Create an unordered map of all id -> index in plots_.
+		std::unordered_map< std::string_view, std::size_t >	plot_id_idx{};
+		for( std::size_t i{}; i<plots_.size(); ++i )		plot_id_idx.insert( { plots_[ i ].id(), i } );
+
+		if( plot_id_idx.size() != plots_.size() ) {
+			throw error_message( std::format( 
+				"plot_id_idx should have {} elements, but only has {}. "
+				"Are you sure that column \"{}\" has unique values on every row, no value ever repeated?", 
+				plots_.size(), plot_id_idx.size(), id_col_name_
 			) );
 		}
+
+		// Find the rows to save, in table order, and what plot they belong to.
+		std::vector< Plot_row >				rows{};
+		rows.reserve( plots_.size() );
+		for( std::size_t r{}; r<plots_table_.rows(); ++r )
+			if( const auto found = plot_id_idx.find( plots_table_[ r, id_col ] ); found != plot_id_idx.end() )
+				rows.emplace_back( r, plots_[ found->second ].metric_aggregators().data() );
+		if( rows.size() != plots_.size() )
+			throw error_message( std::format( "There should be {} rows to save, but there are {}.", 
+				plots_.size(), rows.size() ) );
+		return rows;
 	}
 
 	
 	/// Seve the metrics from each plot to a .csv file, not discarding previous columns. 
-	/// It is a bit roundabout, but we need to include the other columns.
+	/// Only the rows of plots_table_ that are in plots_ are saved, in the same order.
 	inline void save_metrics(
 		const Text_table< char >						  & plots_table_,
 		const std::span< Plot_w_points >					plots_,
 		const dest_path									  & plot_metrics_dest_,
 		const std::span< const metrics::Function_filter >	metrics_,
-		const std::string_view								id_col_name_
+		const std::string_view								id_col_name_,
+		const std::span< const std::string >				suffixes_
 	) {
-		static constexpr const std::string_view	merge_items  = ";{}";	// Semicolon separator.
-		std::vector< std::string >				metric_names{};
 		try{
-			metric_names.reserve( metrics_.size() );
-			for( const auto name : metrics_ )	metric_names.push_back( to_string( name ) );
-
-			if( !plots_.empty() && !plot_metrics_dest_.empty() && !metrics_.empty() ) {
-				const std::size_t 				id_col = plots_table_.header().index( id_col_name_ );
-				if( id_col == -1u )
-					throw error_message( std::format( "In the plots table, there is no column \"{}\".", id_col_name_ ) );
-
-				// Create an unordered map of all id -> index in plots_.
-				std::unordered_map< std::string, std::size_t >		plot_id_idx{};
-				for( std::size_t i{}; i<plots_.size(); ++i )		plot_id_idx.insert( { plots_[ i ].id(), i } );
-
-				if( plot_id_idx.size() != plots_.size() ) {
-					std::cerr << std::format( "plot_id_idx: {}\n", plot_id_idx );
-					throw error_message( std::format( 
-						"plot_id_idx should have {} elements, but only has {}. "
-						"Are you sure that column \"{}\" has unique values on every row, no value ever repeated?", 
-						plots_.size(), plot_id_idx.size(), id_col_name_
-					) );
-				}
-
-				// Usually there are few plots in the plots_table, so we optimize by only working on those few rows.
-				// Carculate a reduced Text_table, with only the rows corresponding to the plots in plots_.
-				Text_table< char >				reduced_table{};
-				{
-					// Create an unordered set of all rows in plots_table_ with the same id as any item in plots_
-					// and use it as a predicative. 
-					std::unordered_set< std::size_t >	table_row_ok{};
-					for( std::size_t i{}; i<plots_table_.rows(); ++i )
-						if( plot_id_idx.contains( std::string( plots_table_[ i, id_col ] ) ) ) {
-							table_row_ok.insert( i );
-						}
-					if( table_row_ok.size() != plots_.size() )
-						throw error_message( std::format( "table_row_ok should have {} elements, but has {}.", 
-							plots_.size(), table_row_ok.size() ) );
-
-					const auto predicate = [ &table_row_ok ]( std::size_t i ) { 
-						return table_row_ok.contains( i ); 
-					};
-
-					reduced_table			  = plots_table_.as_str( predicate );
-				}
-
-				if( reduced_table.rows() != plots_.size() )
-					throw error_message( std::format( "Reduced table should have {} rows, but has {}.", 
-						plots_.size(), reduced_table.rows() ) );
-
-				{	// Create a Text_table with the metrics and insert it into reduced_table.
-					// The order of items must correspond to the order in reduced_table.
-					std::stringstream			out;
-					
-					// Stream the header.
-					if( metric_names.size() ) {
-						auto					itr = metric_names.begin();
-						out << std::format( "{}",   *itr );
-						while( ++itr < metric_names.end() )	
-							out << std::format( merge_items, *itr );
-					}
-
-					// Stream those metric rows that have actual metric values.
-					const auto					begin = metrics_.begin();
-					const auto					end   = metrics_.end();
-					for( std::size_t i{}; i<reduced_table.rows(); ++i ) {
-						const std::size_t		plot_idx = plot_id_idx.at( std::string( reduced_table[ i, id_col ] ) );
-						assert( plots_[ plot_idx ].id() == std::string( reduced_table[ i, id_col ] ) );
-
-						auto				  & metric_aggrs = plots_[ plot_idx ].metric_aggregator();
-						auto					itr   = begin;
-						out << std::format( "\n{}", itr->calculate( metric_aggrs ) );
-						while( ++itr < end )	out << std::format( merge_items, itr->calculate( metric_aggrs ) );
-					}
-					
-					// Create a table and insert it into the original.
-					out << '\n';
-					reduced_table.insert_cols( Text_table< char >{ std::move( out ).str() } );
-				}
-
-				// Save the result. 
-				reduced_table.save( plot_metrics_dest_ );
-			}
+			if( !plots_.empty() && !plot_metrics_dest_.empty() && !metrics_.empty() )
+				save_metric_rows( plots_table_, plot_rows( plots_table_, plots_, id_col_name_ ), 
+					plots_table_.cols(), plot_metrics_dest_, metrics_, suffixes_ );
 		} catch( const std::exception & error_ ) {
+			std::vector< std::string >		metric_names{};
+			for( const auto name : metrics_ )	metric_names.push_back( to_string( name ) );
 			throw error_message( std::format( "{} (Metrics are {}, destination is '{}'.)", 
 				error_.what(), std::span( metric_names ), to_string( plot_metrics_dest_ )
 			) );
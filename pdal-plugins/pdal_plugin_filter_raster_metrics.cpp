@@ -1,5 +1,5 @@
 #include <pax/pdal/modules/pdal_plugin_filter_raster_metrics.hpp>
-#include <pax/pdal/metrics-infrastructure/function-filter.hpp>
+#include <pax/pdal/metrics-infrastructure/metric-kernel.hpp>
 #include <pax/types/point-stuff/box.hpp>
 #include <pax/pdal/utilities/pdal.hpp>
 #include <pax/std/file.hpp>
@@ -18,6 +18,12 @@
 #	include <pdal/private/gdal/Raster.hpp>
 #endif
 
+// gdal
+#include <gdal.h>
+#include <cpl_string.h>		// CPLStringList
+
+#include <memory>			// std::unique_ptr
+
 
 // #include <pax/reporting/debug.hpp>
 // #define DEBUG Debug{}
@@ -44,6 +50,9 @@ std::string function_filter_help() {
 
 namespace pax {
 
+	raster_metrics::~raster_metrics()		{	View_bounds::forget( *this );	}
+
+
 	// This is what prevents this filter to be streaming. 
 	// I can not get the metadata/headerinfo of the files to be processed...
 	void raster_metrics::setting_needs_PointView( pdal::PointViewPtr view_ptr_ ) {
@@ -51,8 +60,19 @@ namespace pax {
 
 		// Raster normally have a reversed y-axis, so we give a negative y resolution.
 		const Point2d				resolution{ m_alignment, -m_alignment };
-		pr_bbox					  = Box_indexer{ box( *view_ptr_ ), resolution };
-		pr_z_accumulators.resize( pr_bbox.elements() );
+		// The view is passed on unchanged, so its bounds are for the next pax stage too.
+		const auto					bbox = box( *this, *view_ptr_ );
+		View_bounds::remember( *this, *view_ptr_, bbox );
+		pr_bbox					  = Box_indexer{ bbox, resolution };
+
+		// With only counts, the heights need not be kept: a cumulative histogram per pixel will do.
+		pr_counts_only			  = metrics::Height_histograms::suitable( pr_metrics_set );
+		if( pr_counts_only )		pr_histograms = metrics::Height_histograms{ pr_metrics_set, pr_bbox.elements() };
+		else {
+			// The pixel values are allocated from an arena: no malloc per pixel, and all is freed at once.
+			pr_z_accumulators.reserve( pr_bbox.elements() );
+			for( std::size_t p{}; p<pr_bbox.elements(); ++p )	pr_z_accumulators.emplace_back( &pr_arena );
+		}
 
 		DEBUG << "raster_metrics::setting_needs_PointView end";		
 	}
@@ -127,12 +147,12 @@ namespace pax {
 		// Process a point (accumulate the z-values of all pixels). 
 		const auto	pt	  = point( pt_ );
 		if( pr_bbox.inside_or_on( pt ) ) {
-			pr_z_accumulators[ pr_bbox.scalar_index( pt ) ].push_back( 
-				pt_.getFieldAs< value_type >( pr_height_dimension ), 
-				pr_has_return_number
+			const auto			z = pt_.getFieldAs< value_type >( pr_height_dimension );
+			const bool			is_first_return = pr_has_return_number
 					? pt_.getFieldAs< std::uint8_t >( pdal::Dimension::Id::ReturnNumber ) == 1 
-					: false
-			);
+					: false;
+			if( pr_counts_only )	pr_histograms.push_back( pr_bbox.scalar_index( pt ), z, is_first_return );
+			else					pr_z_accumulators[ pr_bbox.scalar_index( pt ) ].push_back( z, is_first_return );
 		} else throw std::runtime_error( 
 			std::format( "The point {} is outside the bbox {}.", pt, pr_bbox.box().string() ) );
 		++m_metadata.points_processed;
@@ -167,45 +187,108 @@ namespace pax {
 	}
 
 
+	/// A raster file with a single band, written a block of rows at a time.
+	class Raster_band_writer {
+		struct Close_dataset {
+			void operator()( GDALDatasetH ds_ )	const noexcept	{	GDALClose( ds_ );	}
+		};
+
+		std::filesystem::path							m_dest{};
+		std::unique_ptr< void, Close_dataset >			m_dataset{};
+		GDALRasterBandH									m_band{};
+		std::size_t										m_cols{};
+
+	public:
+		/// Create the raster file dest_, with the driver driver_ and the options options_ ("name=value").
+		Raster_band_writer(
+			const std::filesystem::path		  & dest_,
+			const std::string				  & driver_,
+			const std::size_t					cols_,
+			const std::size_t					rows_,
+			const GDALDataType					type_,
+			Point< double, 6 >					affines_,
+			const std::string				  & srs_wkt_,
+			const double						nodata_,
+			const pdal::StringList			  & options_,
+			const std::string				  & description_
+		) : m_dest{ dest_ }, m_cols{ cols_ } {
+			const GDALDriverH					driver = GDALGetDriverByName( driver_.c_str() );
+			if( !driver )
+				throw error_message( std::format( "There is no GDAL driver '{}'.", driver_ ) );
+			CPLStringList						options{};
+			for( const auto & option : options_ )	options.AddString( option.c_str() );
+			m_dataset.reset( GDALCreate( driver, dest_.c_str(), int( cols_ ), int( rows_ ), 1, type_, options.List() ) );
+			if( !m_dataset )
+				throw error_message( std::format( "Could not create raster file '{}': {}", dest_.native(), CPLGetLastErrorMsg() ) );
+			if( ( GDALSetGeoTransform( m_dataset.get(), affines_.data() ) != CE_None )
+			 || ( !srs_wkt_.empty() && ( GDALSetProjection( m_dataset.get(), srs_wkt_.c_str() ) != CE_None ) ) )
+				throw error_message( std::format( "Could not set the georeference of '{}': {}", dest_.native(), CPLGetLastErrorMsg() ) );
+			m_band							  = GDALGetRasterBand( m_dataset.get(), 1 );
+			GDALSetNoDataValue( m_band, nodata_ );
+			GDALSetDescription( m_band, description_.c_str() );
+		}
+
+		/// Write rows_ rows of values_, starting at row row0_.
+		void write( const std::size_t row0_, const std::size_t rows_, const float * values_ ) {
+			if( GDALRasterIO( m_band, GF_Write, 0, int( row0_ ), int( m_cols ), int( rows_ ), 
+				const_cast< float * >( values_ ), int( m_cols ), int( rows_ ), GDT_Float32, 0, 0 ) != CE_None 
+			)	throw error_message( std::format( "Could not write rows {} to {} of raster file '{}': {}", 
+					row0_, row0_ + rows_, m_dest.native(), CPLGetLastErrorMsg() ) );
+		}
+	};
+
+
 	void raster_metrics::done( pdal::PointTableRef /*table_*/ ) {
 		DEBUG << "raster_metrics::done start";
 		// Save metrics' rasters.
 	    pdal::gdal::registerDrivers();
-		pdal::gdal::GDALError			err;
 
-		// Save one raster for each function-filter (metric).
-		std::vector< value_type >		pixels;
-		pixels.reserve( pr_z_accumulators.size() );
-
-		for( const auto metric : pr_metrics_set ) {
+		// One raster for each function-filter (metric), all open at once.
+		const std::size_t				metric_count = pr_metrics_set.size();
+		const std::size_t				col_count = cols( pr_bbox ), row_count = rows( pr_bbox );
+		const std::string				srs_wkt = m_srs.getWKT();
+		std::vector< Raster_band_writer >	rasters{};
+		rasters.reserve( metric_count );
+		for( const auto & metric : pr_metrics_set ) {
 			const std::filesystem::path	dest{ insert_suffix( m_dest_rasters, to_string( metric ) ) };
 			try {
 				if( !dest.parent_path().empty() )
 					std::filesystem::create_directories( dest.parent_path() );
-
-				// Get the actual metric value for each pixel. 
-				pixels.clear();
-				for( auto & accumulator : pr_z_accumulators ) {
-					pixels.push_back( metric.calculate( accumulator ) );
-				}
-
-				// save_metric( acc, m_dest_rasters, m_accumulators );
-			    pdal::gdal::Raster	raster( dest, m_drivername, m_srs, pr_bbox.gdal_affines() );
-				err					  = raster.open( cols( pr_bbox ), rows( pr_bbox ), 1, m_dataType, m_noData, m_options );
-				if( err == pdal::gdal::GDALError::None )
-					err				  = raster.writeBand( pixels.data(), m_noData, 1, to_string( metric ) );
-
-				// Add metadata of the metrics' destination file. 
-				if( err != pdal::gdal::GDALError::None )	throwError( raster.errorMsg() );
+				rasters.emplace_back( dest, m_drivername, col_count, row_count, pdal::gdal::toGdalType( m_dataType ), 
+					pr_bbox.gdal_affines(), srs_wkt, m_noData, m_options, to_string( metric ) );
 			} catch( const std::exception & e_ ) {
 				throw error_message( std::format( "{} (saving metric to raster file {})", e_.what(), dest.native() ) );
 			}
 		}
+
+		// Calculate all metrics of each pixel at once, so metrics with the same filter share work. 
+		// A preconfigured metric set gets a kernel specialised for it. Only counts are taken from the histograms.
+		// This is done a block of rows at a time, and each block is written to each raster. So the values of 
+		// all metrics are never in memory for the whole raster. Metric m of pixel p of a block is in values[ m*n + p ].
+		static constexpr std::size_t	block_pixels{ std::size_t( 1 ) << 20 };
+		const metrics::Metric_kernel	kernel{ pr_counts_only ? std::span< const metrics::Function_filter >{} : pr_metrics_set };
+		const std::size_t				block_rows = std::max( std::size_t( 1 ), block_pixels/std::max( col_count, std::size_t( 1 ) ) );
+		std::vector< value_type >		values( metric_count*std::min( block_rows, row_count )*col_count );
+		std::vector< value_type >		pixel( metric_count );
+		for( std::size_t row0{}; row0<row_count; row0 += block_rows ) {
+			const std::size_t			block = std::min( block_rows, row_count - row0 );
+			const std::size_t			p0 = row0*col_count, n = block*col_count;
+			for( std::size_t p{}; p<n; ++p ) {
+				if( pr_counts_only )	pr_histograms.calculate( p0 + p, pixel );
+				else					kernel.calculate( pr_z_accumulators[ p0 + p ], pixel );
+				for( std::size_t m{}; m<metric_count; ++m )	values[ m*n + p ] = pixel[ m ];
+			}
+			for( std::size_t m{}; m<metric_count; ++m )		rasters[ m ].write( row0, block, values.data() + m*n );
+		}
+		rasters.clear();		// Closes the files.
 	
 		// Export metadata.
 		pdal::MetadataNode				meta = getMetadata();
 		meta.add( "points-in",			m_metadata.points_processed );
 		meta.add( "has-ReturnNumber",	pr_has_return_number );
+		meta.add( "fused-kernel",		std::string( kernel.fused() ) );
+		meta.add( "height-histograms",	pr_counts_only );
+		meta.add( "arena-bytes",		pr_arena.reserved() );
 		meta.add( "height-dimension",	( pr_height_dimension == pdal::Dimension::Id::HeightAboveGround ) 
 												? "HeightAboveGround" : "Z" );
 
@@ -227,6 +310,10 @@ namespace pax {
 			metrics_node.add( to_string( metric ), dest );
 		}
 		meta.add( metrics_node );
+
+		// The values are not needed any more. The accumulators go first, then the arena returns its pages to the system.
+		pr_z_accumulators				  = {};
+		pr_arena.release();
 		DEBUG << "raster_metrics::done end";
 	}
 
@@ -18,6 +18,9 @@ CREATE_SHARED_STAGE( pax::Remove_overlap, s_info )
 std::string pax::Remove_overlap::getName()		const	{	return s_info.name;		}
 
 
+pax::Remove_overlap::~Remove_overlap()		{	View_bounds::forget( *this );	}
+
+
 void pax::Remove_overlap::addArgs( pdal::ProgramArgs & args_ ) {
 	args_.add(	"overlap_resolution", 
 				"The pixel size. " 
@@ -91,7 +94,7 @@ pdal::PointViewPtr pax::Remove_overlap::overlap_filter( pdal::PointViewPtr view_
 		// Get the bbox, aligned as specified. 
 		// Raster normally have a reversed y-axis, so we give a negative y resolution.
 		const Point2d				resolution{ m_overlap_resolution, -m_overlap_resolution };
-		const Box_indexer			bbox{ pax::box( *view_ ), resolution };
+		const Box_indexer			bbox{ pax::box( *this, *view_ ), resolution };
 		std::vector< Angle_source >	min_angle{ bbox.elements(), Angle_source{} };
 		
 		// Create a raster of minimal angle/point-id pairs.
@@ -106,14 +109,18 @@ pdal::PointViewPtr pax::Remove_overlap::overlap_filter( pdal::PointViewPtr view_
 				std::format( "The point {} is outside the bbox {}.", pt, bbox.box().string() ) );
 		}
 		
-		// Remove all but the minimum points in each raster cell.
+		// Remove all but the minimum points in each raster cell. The bounds of the result are for the next pax stage.
 		pdal::PointViewPtr			points{ view_->makeNew() };
+		Bounds_of_appended			bounds{};
 		for( pdal::PointId idx = 0; idx < size0; ++idx ) {
 			const source_id_type	source_id{ view_->getFieldAs< source_id_type >( ID::PointSourceId, idx ) };
 			const auto pt		  = point( view_, idx );
-			if( min_angle[ bbox.scalar_index( pt ) ].source_id() == source_id ) 
+			if( min_angle[ bbox.scalar_index( pt ) ].source_id() == source_id ) {
 				points->appendPoint( *view_, idx );
+				bounds.add( pt );
+			}
 		}
+		bounds.remember( *this, *points );
 
 		// Return the filtered set of points. 
 	    return points;
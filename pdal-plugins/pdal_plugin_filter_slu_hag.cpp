@@ -0,0 +1,103 @@
+#include <pax/pdal/modules/pdal_plugin_filter_slu_hag.hpp>
+
+#include <pdal/pdal_internal.hpp>
+
+#include <array>
+#include <cmath>		// std::isnan
+
+
+namespace pax {
+
+	static pdal::PluginInfo const s_info {
+		"filters.slu_hag",
+		"Calculates dimension HeightAboveGround from Z and a DEM raster, using bilinear interpolation. "
+		"Only the parts of the DEM that the points fall into are read. "
+		"Execute 'pdal --options filters.slu_hag' for a list of available parameters. ",
+		"https://github.com/Snuggan/pax2/blob/main/documentation/pdal-slu_hag.md"
+	};
+
+	CREATE_SHARED_STAGE( slu_hag, s_info )
+	std::string slu_hag::getName()		const	{	return s_info.name;		}
+
+
+	void slu_hag::addArgs( pdal::ProgramArgs& args_ ) {
+		args_.add(	"raster",
+					"The DEM raster file. It may not be rotated.",
+					m_raster
+		).setPositional();
+		args_.add(	"band",
+					"The band of the DEM raster to use (the first band is 1).",
+					m_band, m_band
+		);
+	}
+
+
+	void slu_hag::addDimensions( pdal::PointLayoutPtr layout_ ) {
+		layout_->registerDim( pdal::Dimension::Id::HeightAboveGround );
+	}
+
+
+	void slu_hag::ready( pdal::PointTableRef /*table_*/ ) {
+		// Not in the constructor, as the argument values are not set then.
+		m_dem				  = Dem_cache{ m_raster, m_band };
+		log()->get( pdal::LogLevel::Debug )
+			<< "\n\tslu_hag arguments:" 
+			<< "\n\traster:            " << m_raster
+			<< "\n\tband:              " << m_band
+			<< "\n";
+	}
+
+
+	bool slu_hag::processOne( pdal::PointRef & pt_ ) {
+		const double	ground	  = m_dem( Point2d{ 
+			pt_.getFieldAs< coordinate_type >( pdal::Dimension::Id::X ), 
+			pt_.getFieldAs< coordinate_type >( pdal::Dimension::Id::Y ) 
+		} );
+		++m_points;
+		m_no_ground			 += std::isnan( ground );
+		pt_.setField( pdal::Dimension::Id::HeightAboveGround, 
+			pt_.getFieldAs< coordinate_type >( pdal::Dimension::Id::Z ) - ground );
+		return true;
+	}
+
+
+	void slu_hag::filter( pdal::PointView & view_ ) {
+		// Handle the points a batch at a time, consecutive points are usually close to each other.
+		constexpr std::size_t							block_size{ 64 };
+		std::array< coordinate_type, block_size >		x, y, ground;
+		for( pdal::PointId first = 0; first < view_.size(); first += block_size ) {
+			const std::size_t		n = std::min< std::size_t >( block_size, view_.size() - first );
+			for( std::size_t i{}; i<n; ++i ) {
+				x[ i ]			  = view_.getFieldAs< coordinate_type >( pdal::Dimension::Id::X, first + i );
+				y[ i ]			  = view_.getFieldAs< coordinate_type >( pdal::Dimension::Id::Y, first + i );
+			}
+			m_dem( std::span( x ).first( n ), std::span( y ).first( n ), std::span( ground ).first( n ) );
+			for( std::size_t i{}; i<n; ++i ) {
+				m_no_ground		 += std::isnan( ground[ i ] );
+				view_.setField( pdal::Dimension::Id::HeightAboveGround, first + i, 
+					view_.getFieldAs< coordinate_type >( pdal::Dimension::Id::Z, first + i ) - ground[ i ] );
+			}
+			m_points			 += n;
+		}
+	}
+
+
+	void slu_hag::done( pdal::PointTableRef /*table_*/ ) {
+		// Create metadata.
+		pdal::MetadataNode					meta = getMetadata();
+				
+		// Metadata: arguments:
+		pdal::MetadataNode					arguments( "arguments" );
+		arguments.add( "raster",			m_raster );
+		arguments.add( "band",				m_band );
+		meta.add( arguments );
+
+		// Metadata: result:
+		pdal::MetadataNode					result( "result" );
+		result.add( "points",				m_points );
+		result.add( "points-without-ground",m_no_ground );
+		result.add( "dem-tiles-read",		m_dem.tiles_read() );
+		meta.add( result );
+	}
+
+}	// namespace pax
@@ -1,8 +1,11 @@
 #include <pax/pdal/modules/pdal_plugin_filter_slu_lm.hpp>
-#include <pax/pdal/utilities/classification.hpp>	// normal_lm_filter()
+#include <pax/pdal/utilities/pdal.hpp>				// View_bounds, x(), y()
 
 #include <pdal/pdal_internal.hpp>
 
+#include <array>
+#include <bit>			// std::countr_zero
+
 
 namespace pax {
 
@@ -23,19 +26,19 @@ namespace pax {
 					"Minimum z: remove points with a z-value smaller than this value. " 
 					"Also, sets all remaining negative z-values to zero. You probably don't want to do use this option "
 					"unless the points are normalized. If 'max_z' has a value smaller than 'min_z', no z-filtering will occur.",
-					m_min_z, m_min_z
+					m_filter.min_z, m_filter.min_z
 		);
 		args_.add(	"max_z",
 					"Maximum z: remove points with a z-value larger than this value. " 
 					"You probably don't want to do use this option unless the points are normalized. "
 					"If 'max_z' has a value smaller than 'min_z', no z-filtering will occur.",
-					m_max_z, m_max_z
+					m_filter.max_z, m_filter.max_z
 		);
 		args_.add(	"lm_filter",
 					"If false, all point classes will pass. " 
 					"If true, only these point classes will pass: "
 					"never classified (0), unspecified (1), and point on ground (2). ",
-					m_lm_filter, m_lm_filter
+					m_filter.lm_filter, m_filter.lm_filter
 		);
 	}
 
@@ -43,9 +46,9 @@ namespace pax {
 	void slu_lm::prepared( pdal::PointTableRef /*table_*/ ) {
 		log()->get( pdal::LogLevel::Debug )
 			<< "\n\tslu_lm arguments:" 
-			<< "\n\tmin_z:             " << m_min_z
-			<< "\n\tmax_z:             " << m_max_z
-			<< "\n\tlm_filter:         " << m_lm_filter
+			<< "\n\tmin_z:             " << m_filter.min_z
+			<< "\n\tmax_z:             " << m_filter.max_z
+			<< "\n\tlm_filter:         " << m_filter.lm_filter
 			<< "\n";
 	}
 
@@ -60,51 +63,51 @@ namespace pax {
 
 		// No z-value filtering?
 		// Do not place in constructor, as the argument values probably are not set then.
-		if( m_max_z < m_min_z ) {
-			m_min_z = std::numeric_limits< decltype( m_min_z ) >::lowest();
-			m_max_z = std::numeric_limits< decltype( m_max_z ) >::max();
-		}
+		m_filter.ready();
 	}
 
 
 	bool slu_lm::processOne( pdal::PointRef & pt_ ) {
-		++m_metadata.points_in;
 		const auto	z		  = pt_.getFieldAs< coordinate_type >( m_height_id );
-		const auto	classif	  = asprs::Classification( 	// From pax/pdal/utilities/classification.hpp
-									pt_.getFieldAs< unsigned    >( pdal::Dimension::Id::Classification ) );
-		if (	( z >= m_min_z ) 
-			&&	( z <= m_max_z ) 
-			&&	( !m_lm_filter || asprs::normal_lm_filter( classif ) ) 
-		) {	
-			// Include the point.
-			++m_metadata.points_out;
-			if( z < 0 ) {	// Negative height.
-				pt_.setField( pdal::Dimension::Id::Z, 0.0 );
-				++m_metadata.z_negative;
-			} else {
-				pt_.setField( pdal::Dimension::Id::Z, z );
-			}
+		if( m_filter.keep( z, pt_.getFieldAs< std::uint8_t >( pdal::Dimension::Id::Classification ) ) ) {
+			pt_.setField( pdal::Dimension::Id::Z, Z_class_filter::clamped( z ) );
 			return true;
 		}
-		// Exclude the point, but count the reason for exclusion.
-		( z < m_min_z )	? ++m_metadata.z_small : 0;
-		( z > m_max_z )	? ++m_metadata.z_large : 0;
-		!normal_lm_filter( classif ) ? ++m_metadata.not_lm : 0;
 		return false;
 	}
 
 
+	slu_lm::~slu_lm()				{	View_bounds::forget( *this );	}
+
+
 	pdal::PointViewSet slu_lm::run( pdal::PointViewPtr view_ ) {
-		// Create a new empty point cloud.
+		// Create a new empty point cloud, and find its bounds while appending (for the next pax stage).
 		pdal::PointViewPtr		points{ view_->makeNew() };
+		Bounds_of_appended		bounds{};
+
+		// Filter the points, a block at a time.
+		constexpr auto				block_size = Z_class_filter::block_size;
+		std::array< coordinate_type, block_size >	z;
+		std::array< std::uint8_t,    block_size >	classif;
+		for( pdal::PointId first = 0; first < view_->size(); first += block_size ) {
+			const std::size_t		n = std::min< std::size_t >( block_size, view_->size() - first );
+			for( std::size_t i{}; i<n; ++i ) {
+				z      [ i ]	  = view_->getFieldAs< coordinate_type >( m_height_id, first + i );
+				classif[ i ]	  = view_->getFieldAs< std::uint8_t >( pdal::Dimension::Id::Classification, first + i );
+			}
 
-		// Filter the points.
-		auto pt = view_->point( 0 );
-		for( pdal::PointId idx = 0; idx < view_->size(); ++idx ) {
-			pt = view_->point( idx );
-			if( processOne( pt ) ) 
+			// Append the remaining points and copy their (non-negative) heights to Z.
+			for( std::uint64_t keep = m_filter.keep( std::span( z ).first( n ), std::span( classif ).first( n ) ); 
+				keep; keep &= keep - 1 
+			) {
+				const std::size_t	i	  = std::countr_zero( keep );
+				const pdal::PointId	idx	  = first + i;
+				view_->setField( pdal::Dimension::Id::Z, idx, Z_class_filter::clamped( z[ i ] ) );
 				points->appendPoint( *view_, idx );
+				bounds.add( x( view_, idx ), y( view_, idx ) );
+			}
 		}
+		bounds.remember( *this, *points );
 
 		// Create new point cloud (pdal::PointViewSet) with the result (pdal::PointViewPtr) and return it.
 		pdal::PointViewSet		result;
@@ -117,26 +120,14 @@ namespace pax {
 		// Create metadata.
 		pdal::MetadataNode					meta = getMetadata();
 				
-		// Metadata: arguments:
-		pdal::MetadataNode					arguments( "arguments" );
-		arguments.add( "min_z",				m_min_z );
-		arguments.add( "max_z",				m_max_z );
-		arguments.add( "lm_filter",			m_lm_filter );
-		meta.add( arguments );
-		
-		// Metadata: filtering:
-		pdal::MetadataNode					filtering( "filtering" );
-		filtering.add( "not-lm",			m_metadata.not_lm );
-		filtering.add( "z-to-large",		m_metadata.z_large );
-		filtering.add( "z-made-zero",		m_metadata.z_negative );
-		filtering.add( "z-to-small",		m_metadata.z_small );
-		meta.add( filtering );
+		// Metadata: arguments and filtering:
+		m_filter.add_metadata( meta );
 
 		// Metadata: result:
 		pdal::MetadataNode					result( "result" );
-		result.add( "points-in",			m_metadata.points_in );
-		result.add( "points-out",			m_metadata.points_out );
-		result.add( "points-removed",		m_metadata.points_in - m_metadata.points_out );
+		result.add( "points-in",			m_filter.counters().points_in );
+		result.add( "points-out",			m_filter.counters().points_out );
+		result.add( "points-removed",		m_filter.counters().points_in - m_filter.counters().points_out );
 		meta.add( result );
 	}
 
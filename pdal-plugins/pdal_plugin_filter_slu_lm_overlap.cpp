@@ -0,0 +1,178 @@
+#include <pax/pdal/modules/pdal_plugin_filter_slu_lm_overlap.hpp>
+#include <pax/types/point-stuff/box.hpp>
+#include <pax/pdal/utilities/pdal.hpp>				// box(), point(), View_bounds
+
+#include <pdal/pdal_internal.hpp>
+
+#include <array>
+#include <bit>			// std::countr_zero
+#include <vector>
+
+
+namespace pax {
+
+	static pdal::PluginInfo const s_info {
+		"filters.slu_lm_overlap",
+		"The same as filters.slu_lm followed by filters.remove_overlap, but in a single pass over the points. "
+		"Execute 'pdal --options filters.slu_lm_overlap' for a list of available parameters. ",
+		"https://github.com/Snuggan/pax2/blob/main/documentation/pdal-slu_lm_overlap.md"
+	};
+
+	CREATE_SHARED_STAGE( slu_lm_overlap, s_info )
+	std::string slu_lm_overlap::getName()		const	{	return s_info.name;		}
+
+
+	slu_lm_overlap::~slu_lm_overlap()		{	View_bounds::forget( *this );	}
+
+
+	void slu_lm_overlap::addArgs( pdal::ProgramArgs& args_ ) {
+		args_.add(	"min_z",
+					"Minimum z: remove points with a z-value smaller than this value. " 
+					"Also, sets all remaining negative z-values to zero. "
+					"If 'max_z' has a value smaller than 'min_z', no z-filtering will occur.",
+					m_filter.min_z, m_filter.min_z
+		);
+		args_.add(	"max_z",
+					"Maximum z: remove points with a z-value larger than this value. " 
+					"If 'max_z' has a value smaller than 'min_z', no z-filtering will occur.",
+					m_filter.max_z, m_filter.max_z
+		);
+		args_.add(	"lm_filter",
+					"If false, all point classes will pass. " 
+					"If true, only these point classes will pass: "
+					"never classified (0), unspecified (1), and point on ground (2). ",
+					m_filter.lm_filter, m_filter.lm_filter
+		);
+		args_.add(	"overlap_resolution", 
+					"The pixel size of the overlap filtering, zero means no overlap filtering. " 
+					"Only points with the same source id as the pixel's source id are accepted. "
+					"The pixel's source id is the source id of the remaining point with the smallest scan angle in the pixel.",
+					m_overlap_resolution, m_overlap_resolution
+		);
+	}
+
+
+	void slu_lm_overlap::addDimensions( pdal::PointLayoutPtr layout_ ) {
+		layout_->registerDim( pdal::Dimension::Id::PointSourceId );
+		layout_->registerDim( pdal::Dimension::Id::ScanAngleRank );
+	}
+
+
+	void slu_lm_overlap::prepared( pdal::PointTableRef /*table_*/ ) {
+		log()->get( pdal::LogLevel::Debug )
+			<< "\n\tslu_lm_overlap arguments:" 
+			<< "\n\tmin_z:              " << m_filter.min_z
+			<< "\n\tmax_z:              " << m_filter.max_z
+			<< "\n\tlm_filter:          " << m_filter.lm_filter
+			<< "\n\toverlap_resolution: " << m_overlap_resolution
+			<< "\n";
+	}
+
+
+	void slu_lm_overlap::ready( pdal::PointTableRef table_ ) {
+		// Use normalized heights, if there are any. See slu_lm::ready.
+		const pdal::PointLayoutPtr	layout = table_.layout();
+		m_height_id	= ( layout->hasDim( pdal::Dimension::Id::HeightAboveGround ) ) 
+			? pdal::Dimension::Id::HeightAboveGround 
+			: pdal::Dimension::Id::Z;
+		m_has_source_id		  = layout->hasDim( pdal::Dimension::Id::PointSourceId );
+		m_has_scan_angle	  = layout->hasDim( pdal::Dimension::Id::ScanAngleRank );
+		m_active			  = ( m_overlap_resolution > 0.0 ) && m_has_source_id && m_has_scan_angle;
+		m_filter.ready();
+	}
+
+
+	pdal::PointViewSet slu_lm_overlap::run( pdal::PointViewPtr view_ ) {
+		using ID					  = pdal::Dimension::Id;
+		const std::size_t				size0{ view_->size() };
+		constexpr auto					block_size = Z_class_filter::block_size;
+
+		// The raster of minimal angle/source-id pairs. The bounds of the unfiltered points contain all 
+		// remaining points. They are passed on by the pax stage before, if any, or else cost a pass over X and Y.
+		// Raster normally have a reversed y-axis, so we give a negative y resolution.
+		const bool						active{ m_active && size0 };
+		const Box_indexer2d				bbox = active
+			? Box_indexer2d{ box( *this, *view_ ), Point2d{ m_overlap_resolution, -m_overlap_resolution } }
+			: Box_indexer2d{};
+		std::vector< Angle_source >		min_angle( active ? bbox.elements() : 0u, Angle_source{} );
+
+		// First pass: filter on z and class, a block at a time, and build the raster from the remaining points.
+		std::vector< std::uint64_t >	keep( ( size0 + block_size - 1 ) / block_size );
+		std::array< coordinate_type, block_size >	z;
+		std::array< std::uint8_t,    block_size >	classif;
+		for( std::size_t b{}; b<keep.size(); ++b ) {
+			const pdal::PointId			first = b * block_size;
+			const std::size_t			n = std::min< std::size_t >( block_size, size0 - first );
+			for( std::size_t i{}; i<n; ++i ) {
+				z      [ i ]		  = view_->getFieldAs< coordinate_type >( m_height_id, first + i );
+				classif[ i ]		  = view_->getFieldAs< std::uint8_t >( ID::Classification, first + i );
+			}
+			keep[ b ]				  = m_filter.keep( std::span( z ).first( n ), std::span( classif ).first( n ) );
+
+			for( std::uint64_t k = keep[ b ]; k; k &= k - 1 ) {
+				const std::size_t		i	  = std::countr_zero( k );
+				const pdal::PointId		idx	  = first + i;
+				view_->setField( ID::Z, idx, Z_class_filter::clamped( z[ i ] ) );
+				if( active ) {
+					const auto			pt	  = point( view_, idx );
+					if( !bbox.inside_or_on( pt ) )	throw std::runtime_error( 
+						std::format( "The point {} is outside the bbox {}.", pt, bbox.box().string() ) );
+					min_angle[ bbox.scalar_index( pt ) ].update(
+						view_->getFieldAs< angle_type     >( ID::ScanAngleRank, idx ), 
+						view_->getFieldAs< source_id_type >( ID::PointSourceId, idx )
+					);
+				}
+			}
+		}
+
+		// Second pass: append the remaining points that are from the pixel's source. 
+		// The bounds of the result are found on the way, for the next pax stage.
+		pdal::PointViewPtr				points{ view_->makeNew() };
+		Bounds_of_appended				bounds{};
+		for( std::size_t b{}; b<keep.size(); ++b ) {
+			for( std::uint64_t k = keep[ b ]; k; k &= k - 1 ) {
+				const pdal::PointId		idx	  = b * block_size + std::countr_zero( k );
+				const auto				pt	  = point( view_, idx );
+				if( !active || ( min_angle[ bbox.scalar_index( pt ) ].source_id() 
+					== view_->getFieldAs< source_id_type >( ID::PointSourceId, idx ) ) 
+				) {
+					points->appendPoint( *view_, idx );
+					bounds.add( pt );
+				}
+			}
+		}
+		bounds.remember( *this, *points );
+		m_points_out				 += points->size();
+
+		// Create new point cloud (pdal::PointViewSet) with the result (pdal::PointViewPtr) and return it.
+		pdal::PointViewSet				result;
+		result.insert( points );
+		return result;
+	}
+
+
+	void slu_lm_overlap::done( pdal::PointTableRef /*table_*/ ) {
+		// Create metadata.
+		pdal::MetadataNode					meta = getMetadata();
+				
+		// Metadata: arguments and filtering:
+		m_filter.add_metadata( meta );
+		meta.findChild( "arguments" ).add( "overlap_resolution", m_overlap_resolution );
+
+		// Metadata: overlap status:
+		pdal::MetadataNode					status( "overlap-status" );
+		status.add( "has-resolution",		m_overlap_resolution > 0.0 );
+		status.add( "has-PointSourceId",	m_has_source_id );
+		status.add( "has-ScanAngleRank",	m_has_scan_angle );
+		status.add( "active",				m_active );
+		meta.add( status );
+
+		// Metadata: result:
+		pdal::MetadataNode					result( "result" );
+		result.add( "points-in",			m_filter.counters().points_in );
+		result.add( "points-out",			m_points_out );
+		result.add( "points-removed",		m_filter.counters().points_in - m_points_out );
+		meta.add( result );
+	}
+
+}	// namespace pax
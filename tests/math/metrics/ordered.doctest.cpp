@@ -129,6 +129,24 @@ namespace pax::metrics {
 			DOCTEST_FAST_CHECK_EQ( ordered::TL_moment_ratio< 3 >( s, 3, 5 ),	doctest::Approx( Correct::TL3_3_5_ratio ) );
 			DOCTEST_FAST_CHECK_EQ( ordered::TL_moment_ratio< 4 >( s, 3, 5 ),	doctest::Approx( Correct::TL4_3_5_ratio ) );
 
+			{
+				const ordered::L_moment_kernel< double >				Lk( s, 1 );
+				DOCTEST_FAST_CHECK_EQ( Lk.L( 1 ),						doctest::Approx( Correct::L1 ) );
+				DOCTEST_FAST_CHECK_EQ( Lk.L( 2 ),						doctest::Approx( Correct::L2 ) );
+				DOCTEST_FAST_CHECK_EQ( Lk.L( 3 ),						doctest::Approx( Correct::L3 ) );
+				DOCTEST_FAST_CHECK_EQ( Lk.L( 4 ),						doctest::Approx( Correct::L4 ) );
+				DOCTEST_FAST_CHECK_EQ( Lk.L_ratio( 2 ),					doctest::Approx( Correct::L2_ratio ) );
+				DOCTEST_FAST_CHECK_EQ( Lk.L_ratio( 3 ),					doctest::Approx( Correct::L3_ratio ) );
+				DOCTEST_FAST_CHECK_EQ( Lk.L_ratio( 4 ),					doctest::Approx( Correct::L4_ratio ) );
+				DOCTEST_FAST_CHECK_EQ( Lk.TL( 1 ),						doctest::Approx( Correct::TL1_1 ) );
+				DOCTEST_FAST_CHECK_EQ( Lk.TL( 2 ),						doctest::Approx( Correct::TL2_1 ) );
+				DOCTEST_FAST_CHECK_EQ( Lk.TL( 3 ),						doctest::Approx( Correct::TL3_1 ) );
+				DOCTEST_FAST_CHECK_EQ( Lk.TL( 4 ),						doctest::Approx( Correct::TL4_1 ) );
+				DOCTEST_FAST_CHECK_UNARY( std::isnan( ordered::L_moment_kernel< double >( s ).TL( 2 ) ) );
+				DOCTEST_FAST_CHECK_UNARY( std::isnan( ordered::L_moment_kernel< double >( s.first( 3 ), 1 ).L( 4 ) ) );
+				DOCTEST_FAST_CHECK_UNARY( std::isnan( ordered::L_moment_kernel< double >( s.first( 3 ), 1 ).TL( 2 ) ) );
+			}
+
 			DOCTEST_FAST_CHECK_EQ( ordered::quantile( s, 0.25 ),		Correct::quartile1 );
 			DOCTEST_FAST_CHECK_EQ( ordered::percentile( s, 25 ),		Correct::quartile1 );
 
@@ -108,6 +108,44 @@ namespace pax::metrics {
 			DOCTEST_FAST_CHECK_EQ( kurtosis_G2( s ),				doctest::Approx( Correct::kurtosis_G2 ) );
 			DOCTEST_FAST_CHECK_EQ( kurtosis_b2( s ),				doctest::Approx( Correct::kurtosis_b2 ) );
 		}
+		DOCTEST_SUBCASE( "bulk" ) {
+			const auto		w{ the_weight< Sum > };
+			Sum				one_by_one{}, bulk{};
+			std::vector< typename Sum::summary_type >	values{};
+			for( auto e : Correct::dataset ) {
+				push( one_by_one, e, w );
+				if constexpr( Sum::uses_weights )	values.emplace_back( typename Sum::value_type( e ), w );
+				else								values.emplace_back( e );
+			}
+			bulk.push_back( std::span( values ).first( 3 ) );		// Fewer values than a lane.
+			bulk.push_back( std::span( values ).subspan( 3 ) );
+
+			DOCTEST_FAST_CHECK_EQ( count( bulk ),					count( one_by_one ) );
+			DOCTEST_FAST_CHECK_EQ( sum< 1 >( bulk ),				doctest::Approx( sum< 1 >( one_by_one ) ) );
+			DOCTEST_FAST_CHECK_EQ( sum< 2 >( bulk ),				doctest::Approx( sum< 2 >( one_by_one ) ) );
+			DOCTEST_FAST_CHECK_EQ( sum< 3 >( bulk ),				doctest::Approx( sum< 3 >( one_by_one ) ) );
+			DOCTEST_FAST_CHECK_EQ( sum< 4 >( bulk ),				doctest::Approx( sum< 4 >( one_by_one ) ) );
+			DOCTEST_FAST_CHECK_EQ( weight< 4 >( bulk ),				weight< 4 >( one_by_one ) );
+			DOCTEST_FAST_CHECK_EQ( sample_kurtosis( bulk ),			doctest::Approx( sample_kurtosis( one_by_one ) ) );
+		}
+		DOCTEST_SUBCASE( "merge" ) {
+			const auto		w{ the_weight< Sum > };
+			Sum				all{}, part1{}, part2{};
+			std::size_t		i{};
+			for( auto e : Correct::dataset ) {
+				push( all, e, w );
+				push( ( i++ % 3 ) ? part1 : part2, e, w );
+			}
+			const Sum		merged = part1 + part2;
+			part1		   += Sum{};
+
+			DOCTEST_FAST_CHECK_EQ( count( merged ),					count( all ) );
+			DOCTEST_FAST_CHECK_EQ( count( part1 ) + count( part2 ),	count( all ) );
+			DOCTEST_FAST_CHECK_EQ( sum< 1 >( merged ),				doctest::Approx( sum< 1 >( all ) ) );
+			DOCTEST_FAST_CHECK_EQ( sum< 4 >( merged ),				doctest::Approx( sum< 4 >( all ) ) );
+			DOCTEST_FAST_CHECK_EQ( weight< 4 >( merged ),			weight< 4 >( all ) );
+			DOCTEST_FAST_CHECK_EQ( sample_skewness( merged ),		doctest::Approx( sample_skewness( all ) ) );
+		}
 		DOCTEST_SUBCASE( "nans" ) {
 			const auto		w{ the_weight< Sum > };
 			const auto		w2( w*w  );
@@ -299,4 +337,21 @@ namespace pax::metrics {
 		}
 	}
 
+	DOCTEST_TEST_CASE( "summary of float values in bulk" ) {
+		// Accumulated as double: as close to the double sums as rounding the float results allows.
+		std::vector< float >	values{};
+		std::vector< double >	doubles{};
+		for( std::size_t i{}; i<10'001; ++i ) {
+			values.push_back( float( ( i*37 ) % 1001 )/7 );
+			doubles.push_back( values.back() );
+		}
+		const auto				s = summary< 4 >( values );
+		const auto				d = summary< 4 >( doubles );
+		DOCTEST_FAST_CHECK_EQ( count( s ),				count( d ) );
+		DOCTEST_FAST_CHECK_EQ( sum< 1 >( s ),			float( sum< 1 >( d ) ) );
+		DOCTEST_FAST_CHECK_EQ( sum< 2 >( s ),			float( sum< 2 >( d ) ) );
+		DOCTEST_FAST_CHECK_EQ( sum< 4 >( s ),			doctest::Approx( sum< 4 >( d ) ).epsilon( 1e-6 ) );
+		DOCTEST_FAST_CHECK_EQ( sample_variance( s ),	doctest::Approx( sample_variance( d ) ).epsilon( 1e-5 ) );
+	}
+
 }	// namespace pax::metrics
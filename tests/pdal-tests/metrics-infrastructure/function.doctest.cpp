@@ -23,6 +23,11 @@ namespace pax::metrics {
 			DOCTEST_FAST_CHECK_EQ( to_string( Function( "L2"		) ), "L2" ); 
 			DOCTEST_FAST_CHECK_EQ( to_string( Function( "L3"		) ), "L3" ); 
 			DOCTEST_FAST_CHECK_EQ( to_string( Function( "L4"		) ), "L4" ); 
+			DOCTEST_FAST_CHECK_EQ( to_string( Function( "Lcv"		) ), "Lcv" ); 
+			DOCTEST_FAST_CHECK_EQ( to_string( Function( "Lskew"		) ), "Lskew" ); 
+			DOCTEST_FAST_CHECK_EQ( to_string( Function( "Lkurt"		) ), "Lkurt" ); 
+			DOCTEST_FAST_CHECK_EQ( to_string( Function( "TL1"		) ), "TL1" ); 
+			DOCTEST_FAST_CHECK_EQ( to_string( Function( "TL4"		) ), "TL4" ); 
 			DOCTEST_FAST_CHECK_EQ( to_string( Function( "mad"		) ), "mad" ); 
 			DOCTEST_FAST_CHECK_EQ( to_string( Function( "p95"		) ), "p95" ); 
 
@@ -35,6 +40,7 @@ namespace pax::metrics {
 			DOCTEST_CHECK_THROWS ( Function( "L0"			) ); 
 			DOCTEST_CHECK_THROWS ( Function( "L5"			) ); 
 			DOCTEST_CHECK_THROWS ( Function( "L2_ratio"		) ); 
+			DOCTEST_CHECK_THROWS ( Function( "TL5"			) ); 
 		}
 		DOCTEST_SUBCASE( "checking the algorithms" ) {
 			std::vector< metrics_value_type >	data0{ std::begin( Correct::dataset ), std::end( Correct::dataset ) };
@@ -50,6 +56,13 @@ namespace pax::metrics {
 			DOCTEST_FAST_CHECK_EQ( Function( "L2"			)( data ), doctest::Approx( Correct::L2 ) ); 
 			DOCTEST_FAST_CHECK_EQ( Function( "L3"			)( data ), doctest::Approx( Correct::L3 ) ); 
 			DOCTEST_FAST_CHECK_EQ( Function( "L4"			)( data ), doctest::Approx( Correct::L4 ) ); 
+			DOCTEST_FAST_CHECK_EQ( Function( "Lcv"			)( data ), doctest::Approx( Correct::L2_ratio ) ); 
+			DOCTEST_FAST_CHECK_EQ( Function( "Lskew"		)( data ), doctest::Approx( Correct::L3_ratio ) ); 
+			DOCTEST_FAST_CHECK_EQ( Function( "Lkurt"		)( data ), doctest::Approx( Correct::L4_ratio ) ); 
+			DOCTEST_FAST_CHECK_EQ( Function( "TL1"			)( data ), doctest::Approx( Correct::TL1_1 ) ); 
+			DOCTEST_FAST_CHECK_EQ( Function( "TL2"			)( data ), doctest::Approx( Correct::TL2_1 ) ); 
+			DOCTEST_FAST_CHECK_EQ( Function( "TL3"			)( data ), doctest::Approx( Correct::TL3_1 ) ); 
+			DOCTEST_FAST_CHECK_EQ( Function( "TL4"			)( data ), doctest::Approx( Correct::TL4_1 ) ); 
 			DOCTEST_FAST_CHECK_EQ( Function( "mad"			)( data ), Correct::mad ); 
 			DOCTEST_FAST_CHECK_EQ( Function( "p75"			)( data ), Correct::quartile3 ); 
 		}
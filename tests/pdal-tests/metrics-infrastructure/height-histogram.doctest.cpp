@@ -0,0 +1,48 @@
+//	Copyright (c) 2014-2016, Peder Axensten, all rights reserved.
+//	Contact: peder ( at ) axensten.se
+
+
+#include <pax/pdal/metrics-infrastructure/height-histogram.hpp>
+#include <pax/pdal/metrics-infrastructure/metric-plan.hpp>
+
+#include <pax/doctest.hpp>
+
+
+namespace pax::metrics { 
+
+	DOCTEST_TEST_CASE( "Height_histograms" ) {
+		const Function_filter	metrics[] = { 
+			Function_filter( "count_all" ),			Function_filter( "count_1ret" ),	Function_filter( "count_all_ge182cm" ),
+			Function_filter( "count_1ret_ge182cm" ),	Function_filter( "count_all_ge500cm_lt1000cm" ),
+			Function_filter( "count_1ret_lt180cm" ),	Function_filter( "count_all_ge1500cm" )
+		};
+		DOCTEST_FAST_CHECK_UNARY( Height_histograms::suitable( metrics ) );
+		DOCTEST_FAST_CHECK_UNARY( !Height_histograms::suitable( std::array{ Function_filter( "count_all" ), Function_filter( "p95_all" ) } ) );
+		DOCTEST_CHECK_THROWS( Height_histograms( std::array{ Function_filter( "mean_all" ) }, 1 ) );
+
+		// The same values as Metric_plan, for each cell.
+		Height_histograms		histograms{ metrics, 3 };
+		DOCTEST_FAST_CHECK_EQ( histograms.cells(),			3u );
+		DOCTEST_FAST_CHECK_EQ( histograms.size(),			std::size( metrics ) );
+		DOCTEST_FAST_CHECK_EQ( histograms.levels().size(),	7u );	// -inf, 1.8, 1.82, 5, 10, 15, +inf
+		std::vector< Point_aggregator >	aggregators( 3 );
+		for( std::size_t i{}; i<600; ++i ) {
+			const metrics_value_type	z = metrics_value_type( ( i*37 ) % 2001 )/100;
+			histograms.push_back( i % 3, z, i % 4 == 0 );
+			aggregators[ i % 3 ].push_back( z, i % 4 == 0 );
+		}
+		histograms.push_back( 2, 1.82f, true );					// Exactly at a level.
+		aggregators[ 2 ].push_back( 1.82f, true );
+
+		const Metric_plan		plan{ metrics };
+		for( std::size_t c{}; c<3; ++c ) {
+			const auto			values = histograms( c );
+			const auto			expected = plan( aggregators[ c ] );
+			for( std::size_t i{}; i<expected.size(); ++i ) {
+				DOCTEST_INFO( to_string( metrics[ i ] ) );
+				DOCTEST_FAST_CHECK_EQ( values[ i ],	expected[ i ] );
+			}
+		}
+	}
+
+}	// namespace pax::metrics
@@ -0,0 +1,45 @@
+//	Copyright (c) 2014-2016, Peder Axensten, all rights reserved.
+//	Contact: peder ( at ) axensten.se
+
+
+#include <pax/pdal/metrics-infrastructure/metric-kernel.hpp>
+
+#include <pax/doctest.hpp>
+
+
+namespace pax::metrics { 
+
+	DOCTEST_TEST_CASE( "Metric_kernel" ) {
+		// The same values as Metric_plan, for the preconfigured sets and for others.
+		for( const std::string_view name : { Basic_linear::name, Inka_berries::name, Extra_allt::name, std::string_view( "p95_all" ) } ) {
+			const std::string		ids[] = { std::string( name ) };
+			const auto				metric_set = metrics::metric_set( std::span( ids ), 1.82 );
+			const Metric_kernel		kernel{ metric_set };
+			const Metric_plan		plan{ metric_set };
+			DOCTEST_INFO( name );
+			DOCTEST_FAST_CHECK_EQ( kernel.size(),		plan.size() );
+			DOCTEST_FAST_CHECK_EQ( kernel.fused(),		( name == "p95_all" ) ? std::string_view{} : name );
+
+			Point_aggregator		data1{}, data2{};
+			for( std::size_t i{}; i<500; ++i ) {
+				const metrics_value_type	z = metrics_value_type( ( i*37 ) % 1001 )/40;
+				data1.push_back( z, i % 3 == 0 );
+				data2.push_back( z, i % 3 == 0 );
+			}
+			const auto				fused = kernel( data1 );
+			const auto				expected = plan( data2 );
+			for( std::size_t i{}; i<expected.size(); ++i ) {
+				DOCTEST_INFO( to_string( metric_set[ i ] ) );
+				if( std::isnan( expected[ i ] ) )	DOCTEST_FAST_CHECK_UNARY( std::isnan( fused[ i ] ) );
+				else								DOCTEST_FAST_CHECK_EQ( fused[ i ],	expected[ i ] );
+			}
+		}
+
+		{	// A preconfigured set with a metric missing is not fused.
+			auto					metric_set = Function_filter::create_set( Basic_linear::name, 1.82 );
+			metric_set.pop_back();
+			DOCTEST_FAST_CHECK_UNARY( Metric_kernel{ metric_set }.fused().empty() );
+		}
+	}
+
+}	// namespace pax::metrics
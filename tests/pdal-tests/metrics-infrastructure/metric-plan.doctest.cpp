@@ -0,0 +1,87 @@
+//	Copyright (c) 2014-2016, Peder Axensten, all rights reserved.
+//	Contact: peder ( at ) axensten.se
+
+
+#include "../../math/metrics/_metrics-key.hpp"
+#include <pax/pdal/metrics-infrastructure/metric-plan.hpp>
+
+#include <pax/doctest.hpp>
+
+
+namespace pax::metrics { 
+
+	DOCTEST_TEST_CASE( "Metric_plan" ) {
+		const auto				metric_set = Function_filter::create_set( "extra-allt", 1.82 );
+		const Metric_plan		plan{ metric_set };
+		DOCTEST_FAST_CHECK_EQ( plan.size(),		metric_set.size() );
+		DOCTEST_FAST_CHECK_EQ( plan.groups(),	10u );
+
+		{	// The same values as when calculated one by one.
+			Point_aggregator	data{ std::span( Correct::dataset ) };
+			const auto			values = plan( data );
+			for( std::size_t i{}; i<metric_set.size(); ++i ) {
+				const auto		expected = metric_set[ i ].calculate( data );
+				DOCTEST_INFO( to_string( metric_set[ i ] ) );
+				if( std::isnan( expected ) )	DOCTEST_FAST_CHECK_UNARY( std::isnan( values[ i ] ) );
+				else							DOCTEST_FAST_CHECK_EQ( values[ i ], doctest::Approx( expected ).epsilon( 0.0001 ) );
+			}
+		} {	// Too few values for the higher L-moments.
+			Point_aggregator	data{};
+			data.push_back( 1.0f, true );
+			data.push_back( 2.0f, true );
+			const Function_filter	metrics[] = { Function_filter( "L2_all" ), Function_filter( "L3_all" ), Function_filter( "mean_all" ),
+										  Function_filter( "Lcv_all" ), Function_filter( "TL2_all" ) };
+			const auto			values = Metric_plan{ metrics }( data );
+			DOCTEST_FAST_CHECK_EQ( values[ 0 ],		doctest::Approx( 0.5f ) );
+			DOCTEST_FAST_CHECK_UNARY( std::isnan( values[ 1 ] ) );
+			DOCTEST_FAST_CHECK_EQ( values[ 2 ],		1.5f );
+			DOCTEST_FAST_CHECK_EQ( values[ 3 ],		doctest::Approx( 0.5f/1.5f ) );
+			DOCTEST_FAST_CHECK_UNARY( std::isnan( values[ 4 ] ) );
+		} {	// The L-moment ratios and TL-moments share the pass of the L-moments.
+			Point_aggregator	data{ std::span( Correct::dataset ) };
+			const Function_filter	metrics[] = { Function_filter( "L2_all" ), Function_filter( "Lskew_all" ),
+										  Function_filter( "TL1_all" ), Function_filter( "TL4_all" ), Function_filter( "Lkurt_1ret" ) };
+			const Metric_plan	plan{ metrics };
+			DOCTEST_FAST_CHECK_EQ( plan.groups(),	2u );
+			const auto			values = plan( data );
+			for( std::size_t i{}; i<std::size( metrics ); ++i ) {
+				const auto		expected = metrics[ i ].calculate( data );
+				DOCTEST_INFO( to_string( metrics[ i ] ) );
+				if( std::isnan( expected ) )	DOCTEST_FAST_CHECK_UNARY( std::isnan( values[ i ] ) );
+				else							DOCTEST_FAST_CHECK_EQ( values[ i ], doctest::Approx( expected ) );
+			}
+			DOCTEST_FAST_CHECK_EQ( values[ 2 ],		doctest::Approx( Correct::TL1_1 ) );
+		}
+	}
+
+	DOCTEST_TEST_CASE( "Metric_plan percentiles without sorting" ) {
+		const Function_filter	metrics[] = { 
+			Function_filter( "p0_all" ),		Function_filter( "p10_all_ge182cm" ),	Function_filter( "p50_all_ge182cm" ),
+			Function_filter( "p95_all_ge182cm" ),	Function_filter( "p100_all_lt500cm" ),	Function_filter( "count_all_ge182cm" ),
+			Function_filter( "count_1ret" ),	Function_filter( "p80_1ret_ge182cm" )
+		};
+		const Metric_plan		plan{ metrics };
+		Point_aggregator		data{};
+		for( std::size_t i{}; i<200; ++i )	
+			data.push_back( metrics_value_type( ( i*37 ) % 101 )/10, i % 3 == 0 );
+		const auto				values = plan( data );
+		DOCTEST_FAST_CHECK_UNARY( !data.is_ordered() );
+
+		// The same values as when sorted.
+		for( std::size_t i{}; i<std::size( metrics ); ++i ) {
+			DOCTEST_INFO( to_string( metrics[ i ] ) );
+			DOCTEST_FAST_CHECK_EQ( values[ i ], metrics[ i ].calculate( data ) );
+		}
+		DOCTEST_FAST_CHECK_UNARY( data.is_ordered() );
+
+		{	// No values within the levels.
+			Point_aggregator	low{};
+			low.push_back( 1.0f, true );
+			const auto			none = plan( low );
+			DOCTEST_FAST_CHECK_UNARY( std::isnan( none[ 2 ] ) );
+			DOCTEST_FAST_CHECK_EQ( none[ 5 ],		0.0f );
+			DOCTEST_FAST_CHECK_EQ( none[ 6 ],		1.0f );
+		}
+	}
+
+}	// namespace pax::metrics
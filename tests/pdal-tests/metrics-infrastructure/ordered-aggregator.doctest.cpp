@@ -141,6 +141,22 @@ namespace pax::metrics {
 			cntr.push_back( 5 );
 			DOCTEST_FAST_CHECK_EQ( size( cntr ),		 5 );
 		}
+		DOCTEST_SUBCASE( "radix sorted" ) {
+			// Enough values pushed at once to be radix sorted, and then a few more to merge.
+			Ordered_vector< float >		cntr{};
+			std::vector< float >		expected{};
+			for( std::size_t i{}; i<3*Ordered_vector< float >::radix_sort_threshold; ++i ) {
+				const float				v = float( ( i*7919 ) % 1013 )/8 - 20;
+				cntr.push_back( v );
+				expected.push_back( v );
+			}
+			DOCTEST_FAST_CHECK_EQ( ordered::min( cntr.ordered_span() ),	-20.0f );
+			push_back_many_( cntr, { 3.5f, -100.0f, 1000.0f } );
+			push_back_many_( expected, { 3.5f, -100.0f, 1000.0f } );
+			std::sort( expected.begin(), expected.end() );
+			const auto					s = cntr.ordered_span();
+			DOCTEST_FAST_CHECK_UNARY( std::equal( s.begin(), s.end(), expected.begin(), expected.end() ) );
+		}
 	}
 
 }	// namespace pax::metrics
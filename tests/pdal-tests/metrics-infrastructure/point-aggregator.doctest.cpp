@@ -3,6 +3,7 @@
 
 
 #include <pax/pdal/metrics-infrastructure/point-aggregator.hpp>
+#include <pax/std/arena.hpp>
 #include <pax/doctest.hpp>
 
 
@@ -49,7 +50,105 @@ namespace pax::metrics {
 			const auto filter	  = Filter( "1ret_ge525cm" );
 			const auto v		  = acc.ordered_span( filter );
 			DOCTEST_FAST_CHECK_EQ( v.size(),		0 );
+		} {	// Ordinary numbers are ordered at construction, for both kinds of filter, also when const.
+			const metrics_value_type	numbers[ 3 ] = { 3, 1, 2 };
+			const Point_aggregator	c_acc{ std::span( numbers ) };
+			DOCTEST_FAST_CHECK_UNARY( c_acc.is_ordered() );
+			DOCTEST_FAST_CHECK_EQ( c_acc.ordered_span( Filter( "all" ) ).size(),	3 );
+			DOCTEST_FAST_CHECK_EQ( c_acc.ordered_span( Filter( "all" ) ).front(),	1 );
+			DOCTEST_FAST_CHECK_EQ( c_acc.ordered_span( Filter( "1ret" ) ).size(),	0 );
 		}
 	}
+
+	DOCTEST_TEST_CASE( "Point_aggregator merge" ) {
+		// The same values as when all points are pushed to one aggregator.
+		Point_aggregator			all{}, part1{}, part2{};
+		for( std::size_t i{}; i<100; ++i ) {
+			const My_pt				pt{ metrics_value_type( ( i*37 ) % 101 )/10, i % 3 == 0 };
+			all.push_back( pt );
+			( ( i % 4 ) ? part1 : part2 ).push_back( pt );
+		}
+		part1.ordered_values( false );		// One ordered and one not.
+		part1					   += part2;
+		for( const bool first_only : { false, true } ) {
+			const auto				expected = all.ordered_values( first_only );
+			const auto				merged = part1.ordered_values( first_only );
+			DOCTEST_FAST_CHECK_UNARY( std::equal( merged.begin(), merged.end(), expected.begin(), expected.end() ) );
+		}
+		part1.merge( Point_aggregator{} );
+		DOCTEST_FAST_CHECK_EQ( part1.ordered_values( false ).size(),	100 );
+	}
+
+	DOCTEST_TEST_CASE( "Point_aggregator arrangements" ) {
+		// Each value is kept once, the values are rearranged for all points or for the first returns.
+		Point_aggregator			acc{};
+		std::vector< metrics_value_type >	all{}, firsts{};
+		const auto	push = [ & ]( const std::size_t begin_, const std::size_t end_ ) {
+			for( std::size_t i{ begin_ }; i<end_; ++i ) {
+				const My_pt			pt{ metrics_value_type( ( i*37 ) % 101 )/10, i % 3 != 0 };
+				acc.push_back( pt );
+				all.push_back( height( pt ) );
+				if( is_first_return( pt ) )		firsts.push_back( height( pt ) );
+			}
+			std::sort( all.begin(), all.end() );
+			std::sort( firsts.begin(), firsts.end() );
+		};
+		const auto	check = [ & ]( const bool first_only_ ) {
+			const auto				values = acc.ordered_values( first_only_ );
+			const auto &			expected = first_only_ ? firsts : all;
+			DOCTEST_FAST_CHECK_UNARY( std::equal( values.begin(), values.end(), expected.begin(), expected.end() ) );
+		};
+
+		push( 0, 50 );
+		{
+			const auto				unordered = acc.unordered_values( true );
+			DOCTEST_FAST_CHECK_EQ( unordered.size(),	firsts.size() );
+			DOCTEST_FAST_CHECK_UNARY( !acc.is_ordered() );
+		}
+		check( true );
+		check( false );
+		push( 50, 400 );
+		check( false );
+		check( true );
+		DOCTEST_FAST_CHECK_UNARY( acc.is_ordered() );
+		DOCTEST_FAST_CHECK_EQ( acc.ordered_span( Filter::ret1_ge( 5 ) ).size(),
+			std::size_t( firsts.end() - std::lower_bound( firsts.begin(), firsts.end(), 5.0f ) ) );
+	}
+
+	DOCTEST_TEST_CASE( "Point_aggregator in an arena" ) {
+		// The same values as with the default allocation.
+		Arena_resource				arena{ 4096 };
+		std::vector< Point_aggregator >	aggregators{};
+		for( std::size_t p{}; p<10; ++p )	aggregators.emplace_back( &arena );
+		Point_aggregator			expected{};
+		for( std::size_t i{}; i<1000; ++i ) {
+			const My_pt				pt{ metrics_value_type( ( i*37 ) % 101 )/10, i % 3 == 0 };
+			aggregators[ i % 10 ].push_back( pt );
+			if( i % 10 == 3 )		expected.push_back( pt );
+		}
+		DOCTEST_FAST_CHECK_GT( arena.used(),	0u );
+		for( const bool first_only : { false, true } ) {
+			const auto				values = aggregators[ 3 ].ordered_values( first_only );
+			const auto				wanted = expected.ordered_values( first_only );
+			DOCTEST_FAST_CHECK_UNARY( std::equal( values.begin(), values.end(), wanted.begin(), wanted.end() ) );
+		}
+	}
+
+	DOCTEST_TEST_CASE( "Point_aggregator scratch memory" ) {
+		// Enough values to be radix sorted. All memory, also scratch buffers, is from the resource (it has no upstream).
+		std::vector< std::byte >	bytes( 1 << 18 );
+		std::pmr::monotonic_buffer_resource	resource{ bytes.data(), bytes.size(), std::pmr::null_memory_resource() };
+		std::vector< metrics_value_type >	all{}, firsts{};
+		for( std::size_t i{}; i<1000; ++i ) {
+			all.push_back( metrics_value_type( ( i*37 ) % 1009 )/10 );
+			if( i % 3 == 0 )		firsts.push_back( all.back() );
+		}
+		Point_aggregator			acc{ &resource };
+		acc.push_back( std::span( all ), std::span( firsts ) );
+		DOCTEST_FAST_CHECK_EQ( acc.ordered_values( false ).size(),	all.size() );
+		DOCTEST_FAST_CHECK_EQ( acc.ordered_values( true  ).size(),	firsts.size() );
+		std::ranges::sort( firsts );
+		DOCTEST_FAST_CHECK_UNARY( std::ranges::equal( acc.ordered_values( true ), firsts ) );
+	}
 	
 }	// namespace pax::metrics
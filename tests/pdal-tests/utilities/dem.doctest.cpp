@@ -0,0 +1,132 @@
+//	Copyright (c) 2014-2016, Peder Axensten, all rights reserved.
+//	Contact: peder ( at ) axensten.se
+
+
+#include <pax/pdal/utilities/dem.hpp>
+#include <pax/doctest.hpp>
+
+#include <filesystem>
+#include <vector>
+
+
+namespace pax { 
+
+	DOCTEST_TEST_CASE( "Dem_tile" ) {
+		static constexpr float	nan = std::numeric_limits< float >::quiet_NaN();
+
+		{	// Heights are col + 10*row, starting at raster pixel ( 2, 3 ).
+			const Dem_tile		tile{ 2, 3, 3, 2, { 32, 33, 34, 42, 43, 44 } };
+			DOCTEST_FAST_CHECK_EQ( tile( 2.0,  3.0  ),	doctest::Approx( 32.0 ) );
+			DOCTEST_FAST_CHECK_EQ( tile( 4.0,  4.0  ),	doctest::Approx( 44.0 ) );
+			DOCTEST_FAST_CHECK_EQ( tile( 2.5,  3.0  ),	doctest::Approx( 32.5 ) );
+			DOCTEST_FAST_CHECK_EQ( tile( 2.5,  3.5  ),	doctest::Approx( 37.5 ) );
+			DOCTEST_FAST_CHECK_EQ( tile( 3.25, 3.75 ),	doctest::Approx( 40.75 ) );
+
+			// Outside the tile, the edge values are used.
+			DOCTEST_FAST_CHECK_EQ( tile( 1.6,  3.0  ),	doctest::Approx( 32.0 ) );
+			DOCTEST_FAST_CHECK_EQ( tile( 4.4,  4.4  ),	doctest::Approx( 44.0 ) );
+			DOCTEST_FAST_CHECK_EQ( tile( 3.5,  2.7  ),	doctest::Approx( 33.5 ) );
+		} {	// No-data values are disregarded.
+			const Dem_tile		tile{ 0, 0, 2, 2, { 10, nan, 20, nan } };
+			DOCTEST_FAST_CHECK_EQ( tile( 0.5,  0.5  ),	doctest::Approx( 15.0 ) );
+			DOCTEST_FAST_CHECK_EQ( tile( 0.0,  0.25 ),	doctest::Approx( 12.5 ) );
+			DOCTEST_FAST_CHECK_EQ( tile( 0.75, 0.0  ),	doctest::Approx( 10.0 ) );
+		} {	// All no-data.
+			const Dem_tile		tile{ 0, 0, 2, 1, { nan, nan } };
+			DOCTEST_FAST_CHECK_UNARY( std::isnan( tile( 0.5, 0.0 ) ) );
+		} {	// A single pixel.
+			const Dem_tile		tile{ 5, 5, 1, 1, { 7 } };
+			DOCTEST_FAST_CHECK_EQ( tile( 5.3,  4.8  ),	doctest::Approx( 7.0 ) );
+		}
+	}
+
+
+	DOCTEST_TEST_CASE( "Dem_cache" ) {
+		static constexpr double	nan = std::numeric_limits< double >::quiet_NaN();
+
+		// A DEM of 3x2 tiles (the last ones partial), with heights col + 1000*row and 2 m pixels. 
+		// Pixel ( 10, 20 ) is no-data.
+		constexpr std::size_t	cols = 2*Dem_cache::tile_side + 88, rows = Dem_cache::tile_side + 44;
+		const auto 				path = std::filesystem::temp_directory_path() / "pax-dem-cache.tif";
+		{
+			std::vector< float >	heights( cols * rows );
+			for( std::size_t r{}; r<rows; ++r )
+				for( std::size_t c{}; c<cols; ++c )		heights[ r*cols + c ] = c + 1000*r;
+			heights[ 20*cols + 10 ]	  = -9999;
+
+			GDALAllRegister();
+			const GDALDatasetH		ds = GDALCreate( GDALGetDriverByName( "GTiff" ), path.c_str(), 
+										int( cols ), int( rows ), 1, GDT_Float32, nullptr );
+			double					affine[ 6 ] = { 1000, 2, 0, 2000, 0, -2 };
+			GDALSetGeoTransform( ds, affine );
+			const GDALRasterBandH	band = GDALGetRasterBand( ds, 1 );
+			GDALSetRasterNoDataValue( band, -9999 );
+			DOCTEST_FAST_CHECK_EQ( GDALRasterIO( band, GF_Write, 0, 0, int( cols ), int( rows ), 
+				heights.data(), int( cols ), int( rows ), GDT_Float32, 0, 0 ), CE_None );
+			GDALClose( ds );
+		}
+
+		// The coordinates of raster position ( col_, row_ ), where pixel centres are at integer values.
+		const auto	at = []( const double col_, const double row_ ){ return Point2d{ 1000 + 2*( col_ + 0.5 ), 2000 - 2*( row_ + 0.5 ) }; };
+		{
+			Dem_cache				dem{ path };
+			DOCTEST_FAST_CHECK_UNARY( bool( dem ) );
+			DOCTEST_FAST_CHECK_EQ( dem.tiles_read(),				0u );
+
+			// Tiles are read when needed, each once.
+			DOCTEST_FAST_CHECK_EQ( dem( at( 3, 4 ) ),				doctest::Approx( 4003 ) );
+			DOCTEST_FAST_CHECK_EQ( dem( at( 3.5, 4.25 ) ),			doctest::Approx( 4253.5 ) );
+			DOCTEST_FAST_CHECK_EQ( dem.tiles_read(),				1u );
+			DOCTEST_FAST_CHECK_EQ( dem( at( 300, 4 ) ),				doctest::Approx( 4300 ) );
+			DOCTEST_FAST_CHECK_EQ( dem.tiles_read(),				2u );
+			DOCTEST_FAST_CHECK_EQ( dem( at( 3, 4 ) ),				doctest::Approx( 4003 ) );
+			DOCTEST_FAST_CHECK_EQ( dem.tiles_read(),				2u );
+
+			// On the tile edges, interpolating between pixels of different tiles.
+			constexpr double		edge = Dem_cache::tile_side - 0.5;
+			DOCTEST_FAST_CHECK_EQ( dem( at( edge, 4 ) ),			doctest::Approx( edge + 4000 ) );
+			DOCTEST_FAST_CHECK_EQ( dem( at( 4, edge ) ),			doctest::Approx( 4 + 1000*edge ) );
+			DOCTEST_FAST_CHECK_EQ( dem( at( edge, edge ) ),			doctest::Approx( edge + 1000*edge ) );
+			DOCTEST_FAST_CHECK_EQ( dem( at( edge + 1, edge + 1 ) ),	doctest::Approx( edge + 1 + 1000*( edge + 1 ) ) );
+
+			// On the DEM edges, the edge pixels are used.
+			DOCTEST_FAST_CHECK_EQ( dem( at( -0.5, 0 ) ),			doctest::Approx( 0 ) );
+			DOCTEST_FAST_CHECK_EQ( dem( at( cols - 0.5, rows - 0.5 ) ),	doctest::Approx( cols - 1 + 1000*( rows - 1 ) ) );
+			DOCTEST_FAST_CHECK_EQ( dem.tiles_read(),				4u );
+
+			// Outside the DEM.
+			DOCTEST_FAST_CHECK_UNARY( std::isnan( dem( at( -0.6, 0 ) ) ) );
+			DOCTEST_FAST_CHECK_UNARY( std::isnan( dem( at( 0, -0.6 ) ) ) );
+			DOCTEST_FAST_CHECK_UNARY( std::isnan( dem( at( cols - 0.4, 3 ) ) ) );
+			DOCTEST_FAST_CHECK_UNARY( std::isnan( dem( at( 3, rows - 0.4 ) ) ) );
+			DOCTEST_FAST_CHECK_UNARY( std::isnan( dem( Point2d{ nan, 1990 } ) ) );
+			DOCTEST_FAST_CHECK_EQ( dem.tiles_read(),				4u );
+
+			// No-data.
+			DOCTEST_FAST_CHECK_UNARY( std::isnan( dem( at( 10, 20 ) ) ) );
+			DOCTEST_FAST_CHECK_EQ( dem( at( 10.5, 20 ) ),			doctest::Approx( 20011 ) );
+			DOCTEST_FAST_CHECK_EQ( dem( at( 10.25, 20.5 ) ),		doctest::Approx( 13006.5/0.625 ) );
+		} {	// A batch gives the same values as one point at a time.
+			Dem_cache				dem{ path }, single{ path };
+			std::vector< double >	x{}, y{};
+			for( std::size_t i{}; i<500; ++i ) {
+				const auto			pt = at( ( i*7919 ) % ( cols + 40 ) - 20.25, ( i*104729 ) % ( rows + 40 ) - 20.75 );
+				x.push_back( pax::x( pt ) );
+				y.push_back( pax::y( pt ) );
+			}
+			std::vector< double >	ground( x.size() );
+			dem( std::span< const double >( x ), std::span< const double >( y ), std::span( ground ) );
+			std::size_t				outside{};
+			for( std::size_t i{}; i<x.size(); ++i ) {
+				const double		expected = single( Point2d{ x[ i ], y[ i ] } );
+				outside			   += std::isnan( expected );
+				if( std::isnan( expected ) )	DOCTEST_FAST_CHECK_UNARY( std::isnan( ground[ i ] ) );
+				else							DOCTEST_FAST_CHECK_EQ( ground[ i ], expected );
+			}
+			DOCTEST_FAST_CHECK_GT( outside,							0u );
+			DOCTEST_FAST_CHECK_EQ( dem.tiles_read(),				single.tiles_read() );
+		}
+		std::filesystem::remove( path );
+	}
+
+}	// namespace pax
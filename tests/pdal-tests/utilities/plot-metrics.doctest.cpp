@@ -0,0 +1,64 @@
+//	Copyright (c) 2014-2016, Peder Axensten, all rights reserved.
+//	Contact: peder ( at ) axensten.se
+
+
+#include <pax/pdal/utilities/plot-metrics.hpp>
+#include <pax/doctest.hpp>
+
+
+namespace pax { 
+
+	DOCTEST_TEST_CASE( "merge_partial_plots" ) {
+		using metrics::Point_aggregator;
+		const auto						dir = std::filesystem::temp_directory_path() / "pax-plot-partials";
+		std::filesystem::create_directories( dir );
+
+		const Text_table< char >		plots{ std::string( "id;east;north;radius\nA;0;0;10\nB;5;5;10\n" ) };
+		{	// The plots A and B are partially in tile 1, A is also partially in tile 2.
+			Point_aggregator			a1{}, b1{}, a2{};
+			a1.push_back( 1.5f, true  );
+			a1.push_back( 2.0f, false );
+			b1.push_back( 3.0f, false );
+			a2.push_back( 4.25f, true );
+			const Plot_row				tile1[] = { { 0, &a1 }, { 1, &b1 } };
+			const Plot_row				tile2[] = { { 0, &a2 } };
+			save_partial_rows( plots, tile1, dir / "tile1.csv" );
+			save_partial_rows( plots, tile2, dir / "tile2.csv" );
+			DOCTEST_FAST_CHECK_EQ( read_string( dir / "tile1.csv" ),
+				"id;east;north;radius;partial_z;partial_z_1ret\nA;0;0;10;1.5 2;1.5\nB;5;5;10;3;\n" );
+		}
+
+		const metrics::Function_filter	metric_set[] = { metrics::Function_filter( "count_all" ), metrics::Function_filter( "count_1ret" ) };
+		const auto						dest = std::filesystem::temp_directory_path() / "pax-plot-partials.csv";
+		const auto						meta = merge_partial_plots( dir, dest, metric_set, "id" );
+		DOCTEST_FAST_CHECK_EQ( meta[ "plots" ].get< std::size_t >(),			2u );
+		DOCTEST_FAST_CHECK_EQ( meta[ "partial-rows" ].get< std::size_t >(),		3u );
+		DOCTEST_FAST_CHECK_EQ( read_string( dest ),
+			"id;east;north;radius;count_all;count_1ret\nA;0;0;10;3;2\nB;5;5;10;1;0\n" );
+		DOCTEST_CHECK_THROWS( merge_partial_plots( dir, dest, metric_set, "no-such-column" ) );
+
+		std::error_code					ec;
+		std::filesystem::remove_all( dir, ec );
+		std::filesystem::remove( dest, ec );
+	}
+
+	DOCTEST_TEST_CASE( "save_metric_rows with several radii" ) {
+		using metrics::Point_aggregator;
+		const Text_table< char >		plots{ std::string( "id;east;north;radius\nA;0;0;10\nB;5;5;10\n" ) };
+		Point_aggregator				a[ 2 ]{}, b[ 2 ]{};			// The plot radius and a larger radius.
+		a[ 0 ].push_back( 1.0f, true  );
+		a[ 1 ].push_back( 1.0f, true  );
+		a[ 1 ].push_back( 2.0f, false );
+		b[ 1 ].push_back( 3.0f, true  );
+		const Plot_row					rows[] = { { 1, b }, { 0, a } };
+		const std::string				suffixes[] = { "", "_r12_5" };
+		const metrics::Function_filter	metric_set[] = { metrics::Function_filter( "count_all" ) };
+		const auto						dest = std::filesystem::temp_directory_path() / "pax-plot-radii.csv";
+		save_metric_rows( plots, rows, plots.cols(), dest, metric_set, suffixes );
+		DOCTEST_FAST_CHECK_EQ( read_string( dest ),
+			"id;east;north;radius;count_all;count_all_r12_5\nB;5;5;10;0;1\nA;0;0;10;1;2\n" );
+		std::error_code					ec;
+		std::filesystem::remove( dest, ec );
+	}
+
+}	// namespace pax
@@ -0,0 +1,48 @@
+//	Copyright (c) 2014-2016, Peder Axensten, all rights reserved.
+//	Contact: peder ( at ) axensten.se
+
+//	Comments are formatted for Doxygen (http://www.doxygen.nl) to read and create documentation.
+
+
+#include <pax/types/point-stuff/circle-index.hpp>
+#include <pax/doctest.hpp>
+
+
+namespace pax {
+
+	DOCTEST_TEST_CASE( "Circle_index" ) {
+		const Box2d						bx{ { 0., 0. }, { 100., 100. } };
+		const std::vector< Circle2d >	circles{
+			Circle2d{ {  10.,  10. }, 5. },
+			Circle2d{ {  12.,  14. }, 5. },
+			Circle2d{ {  50.,  50. }, 5. },
+			Circle2d{ {  97.,  50. }, 5. },		// Partly outside bx.
+		};
+		const auto						index = Circle_index{ bx, std::span< const Circle2d >( circles ) };
+
+		{	// Every point in a circle finds that circle among its candidates.
+			for( std::size_t c{}; c<circles.size(); ++c ) {
+				for( double dx = -5; dx <= 5; dx += 0.5 ) for( double dy = -5; dy <= 5; dy += 0.5 ) {
+					const Point2d		pt{ x( center( circles[ c ] ) ) + dx, y( center( circles[ c ] ) ) + dy };
+					if( contains( circles[ c ], pt ) && bx.inside_or_on( pt ) ) {
+						const auto		found = index( pt );
+						DOCTEST_FAST_CHECK_UNARY( std::find( found.begin(), found.end(), c ) != found.end() );
+					}
+				}
+			}
+		} {	// Few candidates per point.
+			DOCTEST_FAST_CHECK_LE( index( Point2d{ 50., 50. } ).size(), 1u );
+			DOCTEST_FAST_CHECK_EQ( index( Point2d{ 30., 90. } ).size(), 0u );
+		} {	// Outside the grid (the box, aligned to the cell size).
+			DOCTEST_FAST_CHECK_EQ( index( Point2d{ 130., 50. } ).size(), 0u );
+			DOCTEST_FAST_CHECK_EQ( index( Point2d{ -1., -1. } ).size(), 0u );
+		} {	// Not many more cells than circles: the cell side is sqrt( 100*100/17 ), not the diameter.
+			DOCTEST_FAST_CHECK_LE( index.cells(), 25u );
+		} {	// No circles.
+			const auto					empty_index = Circle_index{ bx, std::span< const Circle2d >{} };
+			DOCTEST_FAST_CHECK_EQ( empty_index( Point2d{ 50., 50. } ).size(), 0u );
+			DOCTEST_FAST_CHECK_EQ( Circle_index< double, 2 >{}( Point2d{ 50., 50. } ).size(), 0u );
+		}
+	}
+
+}	// namespace pax
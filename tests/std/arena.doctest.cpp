@@ -0,0 +1,56 @@
+//	Copyright (c) 2014-2016, Peder Axensten, all rights reserved.
+//	Contact: peder ( at ) axensten.se
+
+
+#include <pax/std/arena.hpp>
+#include <pax/doctest.hpp>
+
+
+namespace pax {
+
+	DOCTEST_TEST_CASE( "Arena_resource" ) {
+		Arena_resource				arena{ 4096 };
+		DOCTEST_FAST_CHECK_EQ( arena.pages(),		0u );
+		DOCTEST_FAST_CHECK_EQ( arena.reserved(),	0u );
+
+		{	// Allocations are aligned and rounded up to a power of two.
+			void				  * a = arena.allocate( 3 );
+			void				  * b = arena.allocate( 20, 8 );
+			DOCTEST_FAST_CHECK_EQ( reinterpret_cast< std::uintptr_t >( a ) % alignof( std::max_align_t ),	0u );
+			DOCTEST_FAST_CHECK_EQ( reinterpret_cast< std::uintptr_t >( b ) % alignof( std::max_align_t ),	0u );
+			DOCTEST_FAST_CHECK_EQ( arena.used(),		16u + 32u );
+			DOCTEST_FAST_CHECK_EQ( arena.pages(),		1u );
+
+			// A deallocated block is used again for the same size.
+			arena.deallocate( b, 20, 8 );
+			DOCTEST_FAST_CHECK_EQ( arena.used(),		16u );
+			DOCTEST_FAST_CHECK_EQ( arena.allocate( 32 ),	b );
+			arena.deallocate( a, 3 );
+		}
+		{	// Larger allocations than a page get a page of their own.
+			void				  * big = arena.allocate( 10000, 64 );
+			DOCTEST_FAST_CHECK_EQ( reinterpret_cast< std::uintptr_t >( big ) % 64,	0u );
+			DOCTEST_FAST_CHECK_EQ( arena.pages(),		2u );
+			DOCTEST_FAST_CHECK_GE( arena.reserved(),	4096u + 16384u );
+		}
+		{	// Containers that grow by doubling.
+			std::pmr::vector< float >	values{ &arena };
+			for( std::size_t i{}; i<10000; ++i )	values.push_back( float( i ) );
+			DOCTEST_FAST_CHECK_EQ( values[ 9999 ],	9999.0f );
+		}
+		DOCTEST_FAST_CHECK_UNARY( arena.is_equal( arena ) );
+		DOCTEST_FAST_CHECK_UNARY( !arena.is_equal( *std::pmr::new_delete_resource() ) );
+
+		{	// Released, the pages are returned to the system. The resource may be used again.
+			arena.release();
+			DOCTEST_FAST_CHECK_EQ( arena.pages(),		0u );
+			DOCTEST_FAST_CHECK_EQ( arena.reserved(),	0u );
+			DOCTEST_FAST_CHECK_EQ( arena.used(),		0u );
+			std::pmr::vector< float >	values{ &arena };
+			for( std::size_t i{}; i<100; ++i )	values.push_back( float( i ) );
+			DOCTEST_FAST_CHECK_EQ( values[ 99 ],	99.0f );
+			DOCTEST_FAST_CHECK_EQ( arena.pages(),		1u );
+		}
+	}
+
+}	// namespace pax
@@ -0,0 +1,35 @@
+//	Copyright (c) 2014-2016, Peder Axensten, all rights reserved.
+//	Contact: peder ( at ) axensten.se
+
+
+#include <pax/std/delta-varint.hpp>
+#include <pax/doctest.hpp>
+
+
+namespace pax { 
+
+	DOCTEST_TEST_CASE( "Delta_varint_vector" ) {
+		{	// Empty.
+			const Delta_varint_vector< std::uint64_t >	v{};
+			DOCTEST_FAST_CHECK_UNARY( v.empty() );
+			DOCTEST_FAST_CHECK_UNARY( v.begin() == v.end() );
+		} {	// Small and large steps, and repeated values, read back in order.
+			const std::vector< std::uint64_t >	values{ 5, 6, 6, 7, 200, 201, 70'000, 1ull << 40, ~0ull };
+			Delta_varint_vector< std::uint64_t >	v{};
+			for( const auto value : values )	v.push_back( value );
+			DOCTEST_FAST_CHECK_EQ( v.size(),	values.size() );
+			DOCTEST_FAST_CHECK_UNARY( std::equal( v.begin(), v.end(), values.begin(), values.end() ) );
+			v.clear();
+			DOCTEST_FAST_CHECK_UNARY( v.empty() );
+			DOCTEST_FAST_CHECK_EQ( v.bytes(),	0u );
+		} {	// Dense ids need a byte each.
+			Delta_varint_vector< std::uint64_t >	v{};
+			for( std::uint64_t i = 1'000'000; i<1'001'000; ++i )	v.push_back( i );
+			DOCTEST_FAST_CHECK_EQ( v.size(),	1000u );
+			DOCTEST_FAST_CHECK_EQ( v.bytes(),	1002u );	// The first value needs three bytes.
+			std::uint64_t					expected = 1'000'000;
+			for( const auto value : v )		DOCTEST_FAST_CHECK_EQ( value, expected++ );
+		}
+	}
+
+}	// namespace pax
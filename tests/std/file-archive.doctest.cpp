@@ -0,0 +1,80 @@
+//	Copyright (c) 2014-2016, Peder Axensten, all rights reserved.
+//	Contact: peder ( at ) axensten.se
+
+
+#include <pax/std/file-archive.hpp>
+#include <pax/doctest.hpp>
+
+
+namespace pax {
+
+	DOCTEST_TEST_CASE( "File_archive" ) {
+		const auto 			dir  = std::filesystem::temp_directory_path();
+		const auto 			dest = dir / "pax-file-archive.archive";
+		const auto			as_bytes = []( const std::string_view str_ ){ return std::as_bytes( std::span( str_ ) ); };
+		{
+			File_archive::Writer	writer{ dest };
+			writer.append( "b.laz", as_bytes( "bbbbbbbbbb" ) );
+			writer.append( "a.laz", as_bytes( "a" ) );
+			writer.append( "c.laz", as_bytes( "" ) );
+			DOCTEST_FAST_CHECK_EQ( writer.size(),		3u );
+			writer.close();
+		}
+		DOCTEST_FAST_CHECK_UNARY(  File_archive::is_archive( dest ) );
+		DOCTEST_CHECK_THROWS( File_archive{ doctest_data_root() / "text-table" / "plots.csv" } );
+
+		const File_archive	archive{ dest };
+		DOCTEST_FAST_CHECK_EQ( archive.size(),			3u );
+		DOCTEST_FAST_CHECK_EQ( archive.name( 0 ),		"a.laz" );		// Sorted by name.
+		DOCTEST_FAST_CHECK_EQ( archive.name( 2 ),		"c.laz" );
+		DOCTEST_FAST_CHECK_EQ( archive.find( "b.laz" ),	1u );
+		DOCTEST_FAST_CHECK_EQ( archive.find( "b" ),		3u );
+		DOCTEST_FAST_CHECK_EQ( archive.bytes( 1 ).size(),	10u );
+		DOCTEST_FAST_CHECK_EQ( archive.bytes( 2 ).size(),	0u );
+
+		archive.extract( "b.laz", dir / "pax-file-archive-b.laz" );
+		DOCTEST_FAST_CHECK_EQ( read_string( dir / "pax-file-archive-b.laz" ),	"bbbbbbbbbb" );
+		DOCTEST_CHECK_THROWS( archive.extract( "d.laz", dir / "pax-file-archive-d.laz" ) );
+
+		const auto			twins = dir / "pax-file-archive-twins.archive";
+		{	// The names must be unique. Closing throws, and the temporary file is removed with the writer.
+			File_archive::Writer	writer{ twins };
+			writer.append( "a", as_bytes( "1" ) );
+			writer.append( "a", as_bytes( "2" ) );
+			DOCTEST_CHECK_THROWS( writer.close() );
+		}
+		DOCTEST_FAST_CHECK_UNARY( !std::filesystem::exists( twins ) );
+
+		const auto			corrupt = dir / "pax-file-archive-corrupt.archive";
+		{	// A corrupt index or trailer throws, also if the sizes would overflow.
+			const std::string			good = read_string( dest );
+			File_archive::Trailer		trailer;
+			std::memcpy( &trailer, good.data() + good.size() - sizeof( trailer ), sizeof( trailer ) );
+			const auto	check_throws = [ & ]( const std::size_t at_, const std::uint64_t value_ ) {
+				std::string				bad = good;
+				std::memcpy( bad.data() + at_, &value_, sizeof( value_ ) );
+				{
+					std::ofstream		out{ corrupt, std::ios::out | std::ios::binary | std::ios::trunc };
+					out.write( bad.data(), std::streamsize( bad.size() ) );
+				}
+				DOCTEST_CHECK_THROWS( File_archive{ corrupt } );
+			};
+			const std::size_t			at_trailer = good.size() - sizeof( trailer );
+			check_throws( at_trailer + offsetof( File_archive::Trailer, index ),		good.size() );
+			check_throws( at_trailer + offsetof( File_archive::Trailer, members ),		std::uint64_t( 1 ) << 59 );	// *32 is 0.
+			check_throws( at_trailer + offsetof( File_archive::Trailer, names_size ),	~std::uint64_t{} );
+			check_throws( trailer.index + offsetof( File_archive::Entry, offset ),		trailer.index );
+			check_throws( trailer.index + offsetof( File_archive::Entry, size ),		~std::uint64_t{} );
+			check_throws( trailer.index + offsetof( File_archive::Entry, name_size ),	trailer.names_size + 1 );
+		}
+		for( const auto & entry : std::filesystem::directory_iterator( dir ) )
+			DOCTEST_FAST_CHECK_UNARY( !entry.path().filename().native().starts_with( twins.filename().native() ) );
+
+		std::error_code		ec;
+		std::filesystem::remove( dest, ec );
+		std::filesystem::remove( dir / "pax-file-archive-b.laz", ec );
+		std::filesystem::remove( twins, ec );
+		std::filesystem::remove( corrupt, ec );
+	}
+
+}		// namespace pax
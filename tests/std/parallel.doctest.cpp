@@ -0,0 +1,32 @@
+//	Copyright (c) 2014-2016, Peder Axensten, all rights reserved.
+//	Contact: peder ( at ) axensten.se
+
+
+#include <pax/std/parallel.hpp>
+#include <pax/doctest.hpp>
+
+#include <stdexcept>
+
+
+namespace pax { 
+
+	DOCTEST_TEST_CASE( "parallel_for" ) {
+		for( const std::size_t threads : { 0u, 1u, 3u, 100u } ) {
+			std::vector< std::atomic< int > >	done( 1000 );
+			parallel_for( done.size(), threads, [ & ]( std::size_t i ){	++done[ i ];	} );
+			DOCTEST_FAST_CHECK_UNARY( std::all_of( done.begin(), done.end(), []( const auto & d ){ return d == 1; } ) );
+		} {
+			std::atomic< int >					count{ 0 };
+			parallel_for( 0, 4, [ & ]( std::size_t ){	++count;	} );
+			DOCTEST_FAST_CHECK_EQ( count.load(), 0 );
+		} {
+			DOCTEST_CHECK_THROWS_AS( 
+				parallel_for( 100, 4, []( std::size_t i ){	if( i == 17 ) throw std::runtime_error( "17" );	} ), 
+				std::runtime_error
+			);
+		}
+		DOCTEST_FAST_CHECK_GE( thread_count( 0 ), 1u );
+		DOCTEST_FAST_CHECK_EQ( thread_count( 5 ), 5u );
+	}
+
+}	// namespace pax
@@ -0,0 +1,58 @@
+//	Copyright (c) 2014-2016, Peder Axensten, all rights reserved.
+//	Contact: peder ( at ) axensten.se
+
+
+#include <pax/std/radix-sort.hpp>
+#include <pax/doctest.hpp>
+
+#include <algorithm>	// std::sort, std::equal
+#include <array>
+#include <cmath>		// std::isnan, std::signbit
+#include <limits>
+#include <memory_resource>
+
+
+namespace pax { 
+
+	DOCTEST_TEST_CASE( "radix_sort" ) {
+		{	// Empty and single values.
+			std::vector< float >			v{};
+			radix_sort( std::span( v ) );
+			v.push_back( 3.0f );
+			radix_sort( std::span( v ) );
+			DOCTEST_FAST_CHECK_EQ( v.front(),	3.0f );
+		} {	// The same order as std::sort, with negatives, infinities, denormals, and repeated values.
+			std::vector< double >			v{};
+			for( std::size_t i{}; i<2000; ++i )	v.push_back( double( ( i*7919 ) % 2003 )/7 - 100 );
+			v.insert( v.end(), { 
+				std::numeric_limits< double >::infinity(),	-std::numeric_limits< double >::infinity(),
+				std::numeric_limits< double >::denorm_min(),	-std::numeric_limits< double >::denorm_min(),
+				std::numeric_limits< double >::lowest(),	std::numeric_limits< double >::max(), 5.0, 5.0
+			} );
+			std::vector< double >			expected{ v };
+			std::sort( expected.begin(), expected.end() );
+			radix_sort( std::span( v ) );
+			DOCTEST_FAST_CHECK_UNARY( std::equal( v.begin(), v.end(), expected.begin(), expected.end() ) );
+		} {	// -0 before +0, and NaNs last.
+			std::vector< float >			v{ 1.0f, std::numeric_limits< float >::quiet_NaN(), 0.0f, -0.0f, 
+											  -std::numeric_limits< float >::quiet_NaN(), -1.0f };
+			radix_sort( std::span( v ) );
+			DOCTEST_FAST_CHECK_EQ( v[ 0 ],		-1.0f );
+			DOCTEST_FAST_CHECK_UNARY( std::signbit( v[ 1 ] ) );
+			DOCTEST_FAST_CHECK_UNARY( !std::signbit( v[ 2 ] ) );
+			DOCTEST_FAST_CHECK_EQ( v[ 3 ],		1.0f );
+			DOCTEST_FAST_CHECK_UNARY( std::isnan( v[ 4 ] ) );
+			DOCTEST_FAST_CHECK_UNARY( std::isnan( v[ 5 ] ) );
+		} {	// The scratch buffer is from the given resource: this one has no upstream to fall back on.
+			std::array< std::byte, 3*1000*sizeof( float ) >	bytes;
+			std::pmr::monotonic_buffer_resource	resource{ bytes.data(), bytes.size(), std::pmr::null_memory_resource() };
+			std::vector< float >			v{};
+			for( std::size_t i{}; i<1000; ++i )	v.push_back( float( ( i*7919 ) % 1009 ) - 500 );
+			std::vector< float >			expected{ v };
+			std::sort( expected.begin(), expected.end() );
+			radix_sort( std::span( v ), &resource );
+			DOCTEST_FAST_CHECK_UNARY( std::equal( v.begin(), v.end(), expected.begin(), expected.end() ) );
+		}
+	}
+
+}	// namespace pax
@@ -0,0 +1,58 @@
+//	Copyright (c) 2014-2016, Peder Axensten, all rights reserved.
+//	Contact: peder ( at ) axensten.se
+
+
+#include <pax/tables/plot-catalogue.hpp>
+#include <pax/doctest.hpp>
+
+
+namespace pax {
+
+	DOCTEST_TEST_CASE( "Plot_catalogue" ) {
+		const file_path		source{ doctest_data_root() / "text-table" / "plots.csv" };
+		const auto 			dest = std::filesystem::temp_directory_path() / "plots.paxplots";
+		const auto			meta = Plot_catalogue::build( source, dest );
+		DOCTEST_FAST_CHECK_EQ( meta[ "plots" ].get< std::size_t >(),	6u );
+		DOCTEST_FAST_CHECK_UNARY(  Plot_catalogue::is_catalogue( dest ) );
+		DOCTEST_FAST_CHECK_UNARY( !Plot_catalogue::is_catalogue( source ) );
+		DOCTEST_CHECK_THROWS( Plot_catalogue{ source } );
+
+		const Plot_catalogue	catalogue{ dest };
+		DOCTEST_FAST_CHECK_EQ( catalogue.size(),		6u );
+		DOCTEST_FAST_CHECK_EQ( catalogue.header_row(),	"aaa;east;radius;bbb;ccc;north;Hgv;Volume_overstorey" );
+
+		{	// The plots near a box.
+			const auto		table = catalogue.table( Box2d{ { 517400., 6819900. }, { 517900., 6820400. } } );
+			DOCTEST_FAST_CHECK_EQ( table.cols(),		8u );
+			DOCTEST_FAST_CHECK_EQ( table.rows(),		4u );
+			DOCTEST_FAST_CHECK_EQ( table[ 0, 0 ],		"text1" );
+			DOCTEST_FAST_CHECK_EQ( table[ 1, 0 ],		"text2" );
+			DOCTEST_FAST_CHECK_EQ( table[ 2, 0 ],		"text3" );
+			DOCTEST_FAST_CHECK_EQ( table[ 3, 0 ],		"text6" );
+			DOCTEST_FAST_CHECK_EQ( table[ 3, 5 ],		"6820300" );
+		} {	// A plot just outside the box, but within its radius.
+			const auto		table = catalogue.table( Box2d{ { 517805., 6814000. }, { 518000., 6815000. } } );
+			DOCTEST_FAST_CHECK_EQ( table.rows(),		1u );
+			DOCTEST_FAST_CHECK_EQ( table[ 0, 4 ],		"below" );
+		} {	// A plot outside the box by more than its radius, but within a larger (user enlarged) radius.
+			const Box2d		bbox{ { 517815., 6814000. }, { 518000., 6815000. } };
+			DOCTEST_FAST_CHECK_EQ( catalogue.table( bbox ).rows(),			0u );
+			DOCTEST_FAST_CHECK_EQ( catalogue.table( bbox, 5. ).rows(),		0u );
+			const auto		table = catalogue.table( bbox, 20. );
+			DOCTEST_FAST_CHECK_EQ( table.rows(),		1u );
+			DOCTEST_FAST_CHECK_EQ( table[ 0, 4 ],		"below" );
+		} {	// All plots, in the original order (not in the catalogue order, by band and east).
+			const auto		table = catalogue.table( Box2d{ { 517000., 6815000. }, { 517800., 6820300. } } );
+			DOCTEST_FAST_CHECK_EQ( table.rows(),		6u );
+			for( std::size_t i{}; i<table.rows(); ++i )
+				DOCTEST_FAST_CHECK_EQ( table[ i, 0 ],	std::format( "text{}", i + 1 ) );
+		} {	// No plots.
+			const auto		table = catalogue.table( Box2d{ { 0., 0. }, { 10., 10. } } );
+			DOCTEST_FAST_CHECK_EQ( table.rows(),		0u );
+			DOCTEST_FAST_CHECK_EQ( table.cols(),		8u );
+		}
+		std::error_code		ec;
+		std::filesystem::remove( dest, ec );
+	}
+
+}		// namespace pax
@@ -19,6 +19,7 @@ namespace pax {
 			const std::string_view		table_contentsA ( "r1;r2;r3\na1;a2;1.3\nb1;b2;2.3\nc1;c2;3.3\n" );
 			table					  = Text_table{ std::string{ table_contents } };
 			DOCTEST_FAST_CHECK_EQ( table.as_str(), table_contentsA );
+			DOCTEST_FAST_CHECK_EQ( table.col_mark(), ';' );
 		}
 		{	// Insert columns.
 			const std::string_view		table_contentsB ( "R1;r2;R3\nA4;1;A5\nB4;2;B5\nC4;3;C5\n" );
@@ -0,0 +1,98 @@
+//	Copyright (c) 2014, Peder Axensten
+//	All rights reserved.
+//
+//	Redistribution and use in source and binary forms, with or without
+//	modification, are permitted provided that the following conditions are met:
+//	    * Redistributions of source code must retain the above copyright
+//	      notice, this list of conditions and the following disclaimer.
+//	    * Redistributions in binary form must reproduce the above copyright
+//	      notice, this list of conditions and the following disclaimer in the
+//	      documentation and/or other materials provided with the distribution.
+//	    * Neither the name of the Swedish University of Agricultural Sciences nor the
+//	      names of its contributors may be used to endorse or promote products
+//	      derived from this software without specific prior written permission.
+//
+//	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//	ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//	WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//	DISCLAIMED. IN NO EVENT SHALL PEDER AXENSTEN BE LIABLE FOR ANY
+//	DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//	(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//	LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//	ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//	(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//	SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+/** \file **/
+
+
+#define DOCTEST_CONFIG_DISABLE		// "remove" everything pertaining to doctest.
+
+#include <pax/pdal/utilities/plot-metrics.hpp>
+#include <pax/meta/meta.hpp>
+#include <pax/meta/cmd-arguments.hpp>
+
+
+namespace pax { 
+	const Meta2			meta2 {
+		"pax-merge-plot-partials",
+		"pax-merge-plot-partials --source=<directory path> --dest=<file path> --metrics=<metrics>", 
+		"Calculates the metrics of plots that are split between point cloud files.", 
+
+		"filters.plot_stuff saves the values of plots partially within a point cloud to 'plot_partials_dest'. "
+		"This tool merges those files, by plot id, and saves the metrics of the merged plots in the same format "
+		"as the plot metrics files. So no point cloud file needs to be read twice to get the metrics of such plots.\n"
+		"1. Concatenate the partial plot files in the source directory (they must have the same header).\n"
+		"2. Merge the values of rows with the same plot id.\n"
+		"3. Calculate the metrics and save them."
+	};
+
+	std::string function_filter_help() {
+		std::ostringstream			stream;
+		metrics::Function_filter::help( stream, "" );
+		return stream.str();
+	}
+
+	int main_merge_plot_partials( int argc, const char **argv ) {
+		std::filesystem::path		source, dest;
+		std::string					trouble;
+
+		try {
+			const auto parameters = cmd_args::Parameters{ meta2.info(), meta2.description(), meta2.usage() }
+				( 	's', "source",	ANSI_BOLD"Source path." ANSI_RESET" Directory of the partial plot files."				)
+				( 	'd', "dest",	ANSI_BOLD"Destination path." ANSI_RESET" Path of the resulting metrics file."			)
+				( 	"metrics",		function_filter_help(), cmd_args::Parameter_type::one_or_more_values()					)
+				( 	"nilsson_level","For some metrics, ignore z-values below this value.", cmd_args::Default_value( "0.0" )	)
+				( 	"id_column",	"In what column to find the [unique] plot id.", cmd_args::Default_value( "id" )			)
+				(	'm', "meta", 	"Save metadata files with execution info.",		cmd_args::Parameter_type::off_flag()	)
+				;
+
+			const auto args		  = parameters.parse( argc, argv );
+			source				  = args.cast< std::filesystem::path >( "source" );
+			dest				  = args.cast< std::filesystem::path >( "dest" );
+			trouble				  = std::format( "Tool\t{}\nSource\t{}\nDestination\t{}\n", 
+										meta2.name(), to_string( source ), to_string( dest ) );
+
+			const auto metric_set = metrics::metric_set( std::span{ args( "metrics" ) }, args.cast< double >( "nilsson_level" ) );
+			const auto meta_res	  = merge_partial_plots( source, dest, metric_set, args.cast< std::string >( "id_column" ) );
+
+			// Save json file.
+			if( args.flag( "meta" ) ) {
+				Json_value json						= to_json( meta2 );
+				json[ "execution" ][ "arguments" ]	= args;
+				json[ "execution" ][ "result" ]		= meta_res;
+				save_json( dest, json );
+			}
+			return EXIT_SUCCESS;
+		} 
+		catch( Runtime_exception    & e_ )	{	std::cerr << ( e_ << trouble ).what();										} 
+		catch( const std::exception & e_ )	{	std::cerr << ( error_message( e_.what() ) << trouble ).what();				} 
+		catch( ... ) 						{	std::cerr << ( error_message( "<Unknown_exception>" ) << trouble ).what();	}
+
+		const auto failure = std::format( ANSI_BOLD"{} failed to merge {}\n" ANSI_RESET, meta2.name(), to_string( source ) );
+		fprintf( stderr, "%s", failure.c_str() );
+		return EXIT_FAILURE;
+	}
+}	// namespace pax
+
+int main( int argc, const char **argv )	{	return pax::main_merge_plot_partials( argc, argv );			}
@@ -0,0 +1,114 @@
+//	Copyright (c) 2014, Peder Axensten
+//	All rights reserved.
+//
+//	Redistribution and use in source and binary forms, with or without
+//	modification, are permitted provided that the following conditions are met:
+//	    * Redistributions of source code must retain the above copyright
+//	      notice, this list of conditions and the following disclaimer.
+//	    * Redistributions in binary form must reproduce the above copyright
+//	      notice, this list of conditions and the following disclaimer in the
+//	      documentation and/or other materials provided with the distribution.
+//	    * Neither the name of the Swedish University of Agricultural Sciences nor the
+//	      names of its contributors may be used to endorse or promote products
+//	      derived from this software without specific prior written permission.
+//
+//	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//	ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//	WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//	DISCLAIMED. IN NO EVENT SHALL PEDER AXENSTEN BE LIABLE FOR ANY
+//	DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//	(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//	LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//	ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//	(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//	SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+/** \file **/
+
+#define DOCTEST_CONFIG_DISABLE		// "remove" everything pertaining to doctest.
+
+#include <pax/std/file-archive.hpp>
+#include <pax/textual/json.hpp>
+#include <pax/meta/meta.hpp>
+#include <pax/meta/cmd-arguments.hpp>
+
+
+namespace pax { 
+	const Meta2			meta2 {
+		"pax-plot-archive",
+		"pax-plot-archive --source=<file path> --dest=<directory path> [--plots=<plot ids>]", 
+		"Extracts plot point cloud files from an archive, as saved by filters.plot_stuff.", 
+
+		"Given 'plot_points_archive', filters.plot_stuff saves the point clouds of all plots of a point cloud "
+		"in a single archive file, instead of one file per plot.\n"
+		"This tool saves the plots in the archive as standalone files in the destination directory, "
+		"named by plot id (and the point cloud format suffix). Without '--plots', all plots are extracted."
+	};
+
+	int main_plot_archive( int argc, const char **argv ) {
+		std::filesystem::path		source, dest;
+		std::string					trouble;
+
+		try {
+			const auto parameters = cmd_args::Parameters{ meta2.info(), meta2.description(), meta2.usage() }
+				( 	's', "source",	ANSI_BOLD"Source path." ANSI_RESET" The plot archive file."							)
+				( 	'd', "dest",	ANSI_BOLD"Destination path." ANSI_RESET" Directory for the extracted files."			)
+				( 	"plots",		"The ids of the plots to extract (default is all).", cmd_args::Parameter_type::zero_or_more_values()	)
+				(	'm', "meta", 	"Save metadata files with execution info.",		cmd_args::Parameter_type::off_flag()	)
+				;
+
+			const auto args		  = parameters.parse( argc, argv );
+			source				  = args.cast< std::filesystem::path >( "source" );
+			dest				  = args.cast< std::filesystem::path >( "dest" );
+			trouble				  = std::format( "Tool\t{}\nSource\t{}\nDestination\t{}\n", 
+										meta2.name(), to_string( source ), to_string( dest ) );
+
+			const File_archive		archive{ source };
+			const dir_path			dest_dir{ dest };
+			std::vector< std::string >	extracted{};
+
+			// Extract member i_ to dest_dir. Only plain file names, so nothing is written outside of dest_dir.
+			const auto extract	  = [ & ]( const std::size_t i_ ) {
+				const std::string_view	name = archive.name( i_ );
+				if( name.empty() || ( name == "." ) || ( name == ".." ) || ( name.find_first_of( "/\\" ) != std::string_view::npos ) )
+					throw error_message( std::format( "The archive member '{}' is not a plain file name, it is not extracted.", name ) );
+				archive.extract( name, dest_dir / name );
+				extracted.emplace_back( name );
+			};
+			if( args( "plots" ).empty() ) {
+				for( std::size_t i{}; i<archive.size(); ++i )	extract( i );
+			} else {
+				// The members are named by plot id and format suffix, so look for the plot id as the file stem.
+				for( const auto & plot : args( "plots" ) ) {
+					std::size_t		i = archive.find( plot );
+					for( std::size_t j{}; ( i == archive.size() ) && ( j < archive.size() ); ++j )
+						if( std::filesystem::path( archive.name( j ) ).stem() == plot )		i = j;
+					if( i == archive.size() )
+						throw error_message( std::format( "There is no plot '{}' in the archive.", plot ) );
+					extract( i );
+				}
+			}
+
+			// Save json file.
+			if( args.flag( "meta" ) ) {
+				Json_value json						= to_json( meta2 );
+				json[ "execution" ][ "arguments" ]	= args;
+				json[ "execution" ][ "result" ]		= Json_value{
+					{	"plots-in-archive",	archive.size()		},
+					{	"extracted",		extracted			}
+				};
+				save_json( dest / source.filename(), json );
+			}
+			return EXIT_SUCCESS;
+		} 
+		catch( Runtime_exception    & e_ )	{	std::cerr << ( e_ << trouble ).what();										} 
+		catch( const std::exception & e_ )	{	std::cerr << ( error_message( e_.what() ) << trouble ).what();				} 
+		catch( ... ) 						{	std::cerr << ( error_message( "<Unknown_exception>" ) << trouble ).what();	}
+
+		const auto failure = std::format( ANSI_BOLD"{} failed to extract from {}\n" ANSI_RESET, meta2.name(), to_string( source ) );
+		fprintf( stderr, "%s", failure.c_str() );
+		return EXIT_FAILURE;
+	}
+}	// namespace pax
+
+int main( int argc, const char **argv )	{	return pax::main_plot_archive( argc, argv );			}
@@ -0,0 +1,87 @@
+//	Copyright (c) 2014, Peder Axensten
+//	All rights reserved.
+//
+//	Redistribution and use in source and binary forms, with or without
+//	modification, are permitted provided that the following conditions are met:
+//	    * Redistributions of source code must retain the above copyright
+//	      notice, this list of conditions and the following disclaimer.
+//	    * Redistributions in binary form must reproduce the above copyright
+//	      notice, this list of conditions and the following disclaimer in the
+//	      documentation and/or other materials provided with the distribution.
+//	    * Neither the name of the Swedish University of Agricultural Sciences nor the
+//	      names of its contributors may be used to endorse or promote products
+//	      derived from this software without specific prior written permission.
+//
+//	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+//	ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+//	WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+//	DISCLAIMED. IN NO EVENT SHALL PEDER AXENSTEN BE LIABLE FOR ANY
+//	DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+//	(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+//	LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+//	ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+//	(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//	SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+/** \file **/
+
+
+#define DOCTEST_CONFIG_DISABLE		// "remove" everything pertaining to doctest.
+
+#include <pax/tables/plot-catalogue.hpp>
+#include <pax/meta/meta.hpp>
+#include <pax/meta/cmd-arguments.hpp>
+
+
+namespace pax { 
+	const Meta2			meta2 {
+		"pax-plot-catalogue",
+		"pax-plot-catalogue --source=<file path> --dest=<file path>", 
+		"Converts a plots csv file to a binary plot catalogue, for filters.plot_stuff to use.", 
+
+		"The plots file is parsed once and saved with its plots sorted spatially, so that "
+		"each filters.plot_stuff run only memory maps it and looks up the plots within its point cloud, "
+		"instead of reading and parsing the whole plots file.\n"
+		"The catalogue keeps the original header, row text, and row order, so the resulting metrics files are the same.\n"
+		"The catalogue is in the native byte order, create it on the machine where it is used."
+	};
+
+	int main_plot_catalogue( int argc, const char **argv ) {
+		std::filesystem::path		source, dest;
+		std::string					trouble;
+
+		try {
+			const auto parameters = cmd_args::Parameters{ meta2.info(), meta2.description(), meta2.usage() }
+				( 	's', "source",	ANSI_BOLD"Source path." ANSI_RESET" The plots csv file, with at least the columns 'east', 'north', and 'radius'."	)
+				( 	'd', "dest",	ANSI_BOLD"Destination path." ANSI_RESET" Path of the resulting plot catalogue."		)
+				(	'm', "meta", 	"Save metadata files with execution info.",		cmd_args::Parameter_type::off_flag()	)
+				;
+
+			const auto args		  = parameters.parse( argc, argv );
+			source				  = args.cast< std::filesystem::path >( "source" );
+			dest				  = args.cast< std::filesystem::path >( "dest" );
+			trouble				  = std::format( "Tool\t{}\nSource\t{}\nDestination\t{}\n", 
+										meta2.name(), to_string( source ), to_string( dest ) );
+
+			const auto meta_res	  = Plot_catalogue::build( source, dest );
+
+			// Save json file.
+			if( args.flag( "meta" ) ) {
+				Json_value json						= to_json( meta2 );
+				json[ "execution" ][ "arguments" ]	= args;
+				json[ "execution" ][ "result" ]		= meta_res;
+				save_json( dest, json );
+			}
+			return EXIT_SUCCESS;
+		} 
+		catch( Runtime_exception    & e_ )	{	std::cerr << ( e_ << trouble ).what();										} 
+		catch( const std::exception & e_ )	{	std::cerr << ( error_message( e_.what() ) << trouble ).what();				} 
+		catch( ... ) 						{	std::cerr << ( error_message( "<Unknown_exception>" ) << trouble ).what();	}
+
+		const auto failure = std::format( ANSI_BOLD"{} failed to convert {}\n" ANSI_RESET, meta2.name(), to_string( source ) );
+		fprintf( stderr, "%s", failure.c_str() );
+		return EXIT_FAILURE;
+	}
+}	// namespace pax
+
+int main( int argc, const char **argv )	{	return pax::main_plot_catalogue( argc, argv );			}